@@ -0,0 +1,113 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__ALLOCATION_TRACKING_HPP_
+#define RCLCPP__ALLOCATION_TRACKING_HPP_
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+/// Counting of the heap allocations made by a thread, to check that a code path doesn't allocate.
+/**
+ * This is only available in programs linking the rclcpp_allocation_tracking
+ * library, which replaces the global operator new and operator delete, including
+ * their aligned forms, and on glibc also malloc(), calloc(), realloc(),
+ * aligned_alloc(), posix_memalign(), memalign() and free(), with versions
+ * counting each call per thread.
+ * It is only built for the tests of rclcpp, except on Windows, and not installed.
+ *
+ * Typical use, once the system is warmed up:
+ *
+ * \code
+ * rclcpp::allocation_tracking::expect_no_allocations(
+ *   [&]() {executor.spin_some();}, "spin_some");
+ * \endcode
+ */
+namespace allocation_tracking
+{
+
+/// Number of allocations, deallocations and bytes allocated by a thread.
+struct AllocationCounts
+{
+  size_t allocations = 0;
+  size_t deallocations = 0;
+  size_t bytes_allocated = 0;
+};
+
+/// Return the counts of the calling thread since it started.
+RCLCPP_PUBLIC
+AllocationCounts
+get_thread_allocation_counts();
+
+/// Count the allocations of the calling thread from construction on.
+class ScopedAllocationCounter
+{
+public:
+  ScopedAllocationCounter()
+  : start_(get_thread_allocation_counts())
+  {}
+
+  /// Return the counts of the calling thread since construction.
+  AllocationCounts
+  get_counts() const
+  {
+    AllocationCounts now = get_thread_allocation_counts();
+    now.allocations -= start_.allocations;
+    now.deallocations -= start_.deallocations;
+    now.bytes_allocated -= start_.bytes_allocated;
+    return now;
+  }
+
+private:
+  const AllocationCounts start_;
+};
+
+/// Call the function and return the allocations it made in the calling thread.
+template<typename FunctorT>
+AllocationCounts
+count_allocations(FunctorT && function)
+{
+  ScopedAllocationCounter counter;
+  std::forward<FunctorT>(function)();
+  return counter.get_counts();
+}
+
+/// Call the function and throw if it allocated in the calling thread.
+/**
+ * \param[in] function the code to check.
+ * \param[in] description what the code does, for the error message.
+ * \throws std::runtime_error if the function allocated.
+ */
+template<typename FunctorT>
+void
+expect_no_allocations(FunctorT && function, const std::string & description)
+{
+  AllocationCounts counts = count_allocations(std::forward<FunctorT>(function));
+  if (counts.allocations > 0) {
+    throw std::runtime_error(
+            description + " made " + std::to_string(counts.allocations) +
+            " allocations of " + std::to_string(counts.bytes_allocated) + " bytes in total");
+  }
+}
+
+}  // namespace allocation_tracking
+}  // namespace rclcpp
+
+#endif  // RCLCPP__ALLOCATION_TRACKING_HPP_
@@ -15,8 +15,13 @@
 #ifndef RCLCPP__ALLOCATOR__ALLOCATOR_COMMON_HPP_
 #define RCLCPP__ALLOCATOR__ALLOCATOR_COMMON_HPP_
 
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
 #include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
 
 #include "rcl/allocator.h"
 
@@ -79,12 +84,85 @@ void * retyped_reallocate(void * untyped_pointer, size_t size, void * untyped_al
   return std::allocator_traits<Alloc>::allocate(*typed_allocator, size);
 }
 
+template<typename Alloc>
+struct is_polymorphic_allocator : std::false_type {};
+
+template<typename T>
+struct is_polymorphic_allocator<std::pmr::polymorphic_allocator<T>>: std::true_type {};
+
+// Memory resources need the size to deallocate, which rcl doesn't pass, so it is stored in front
+// of each block allocated for rcl.
+constexpr size_t resource_block_header_size = alignof(std::max_align_t);
+static_assert(resource_block_header_size >= sizeof(size_t), "header too small for the size");
+
+template<typename Alloc>
+void * resource_allocate(size_t size, void * untyped_allocator)
+{
+  auto typed_allocator = static_cast<Alloc *>(untyped_allocator);
+  if (!typed_allocator) {
+    throw std::runtime_error("Received incorrect allocator type");
+  }
+  void * block = nullptr;
+  try {
+    block = typed_allocator->resource()->allocate(
+      resource_block_header_size + size, alignof(std::max_align_t));
+  } catch (const std::bad_alloc &) {
+    // This is called from rcl, which can't handle exceptions but reports a null pointer.
+    return nullptr;
+  }
+  *static_cast<size_t *>(block) = size;
+  return static_cast<std::byte *>(block) + resource_block_header_size;
+}
+
+template<typename Alloc>
+void * resource_zero_allocate(size_t number_of_elem, size_t size_of_elem, void * untyped_allocator)
+{
+  size_t size = number_of_elem * size_of_elem;
+  void * allocated_memory = resource_allocate<Alloc>(size, untyped_allocator);
+  if (allocated_memory) {
+    std::memset(allocated_memory, 0, size);
+  }
+  return allocated_memory;
+}
+
+template<typename Alloc>
+void resource_deallocate(void * untyped_pointer, void * untyped_allocator)
+{
+  auto typed_allocator = static_cast<Alloc *>(untyped_allocator);
+  if (!typed_allocator) {
+    throw std::runtime_error("Received incorrect allocator type");
+  }
+  if (!untyped_pointer) {
+    return;
+  }
+  void * block = static_cast<std::byte *>(untyped_pointer) - resource_block_header_size;
+  typed_allocator->resource()->deallocate(
+    block, resource_block_header_size + *static_cast<size_t *>(block), alignof(std::max_align_t));
+}
+
+template<typename Alloc>
+void * resource_reallocate(void * untyped_pointer, size_t size, void * untyped_allocator)
+{
+  void * allocated_memory = resource_allocate<Alloc>(size, untyped_allocator);
+  if (!allocated_memory) {
+    // Like realloc(), the old block is left untouched.
+    return nullptr;
+  }
+  if (untyped_pointer) {
+    size_t old_size = *reinterpret_cast<size_t *>(
+      static_cast<std::byte *>(untyped_pointer) - resource_block_header_size);
+    std::memcpy(allocated_memory, untyped_pointer, std::min(old_size, size));
+    resource_deallocate<Alloc>(untyped_pointer, untyped_allocator);
+  }
+  return allocated_memory;
+}
 
 // Convert a std::allocator_traits-formatted Allocator into an rcl allocator
 template<
   typename T,
   typename Alloc,
-  typename std::enable_if<!std::is_same<Alloc, std::allocator<void>>::value>::type * = nullptr>
+  typename std::enable_if<!std::is_same<Alloc, std::allocator<void>>::value &&
+  !is_polymorphic_allocator<Alloc>::value>::type * = nullptr>
 rcl_allocator_t get_rcl_allocator(Alloc & allocator)
 {
   rcl_allocator_t rcl_allocator = rcl_get_default_allocator();
@@ -100,6 +178,26 @@ rcl_allocator_t get_rcl_allocator(Alloc & allocator)
   return rcl_allocator;
 }
 
+// Convert a polymorphic allocator into an rcl allocator using its memory resource
+template<
+  typename T,
+  typename Alloc,
+  typename std::enable_if<is_polymorphic_allocator<Alloc>::value>::type * = nullptr>
+rcl_allocator_t get_rcl_allocator(Alloc & allocator)
+{
+  rcl_allocator_t rcl_allocator = rcl_get_default_allocator();
+#ifndef _WIN32
+  rcl_allocator.allocate = &resource_allocate<Alloc>;
+  rcl_allocator.zero_allocate = &resource_zero_allocate<Alloc>;
+  rcl_allocator.deallocate = &resource_deallocate<Alloc>;
+  rcl_allocator.reallocate = &resource_reallocate<Alloc>;
+  rcl_allocator.state = &allocator;
+#else
+  (void)allocator;  // Remove warning
+#endif
+  return rcl_allocator;
+}
+
 // TODO(jacquelinekay) Workaround for an incomplete implementation of std::allocator<void>
 template<
   typename T,
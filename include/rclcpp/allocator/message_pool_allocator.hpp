@@ -0,0 +1,205 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__ALLOCATOR__MESSAGE_POOL_ALLOCATOR_HPP_
+#define RCLCPP__ALLOCATOR__MESSAGE_POOL_ALLOCATOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/context.hpp"
+#include "rclcpp/contexts/default_context.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace allocator
+{
+
+/// Pools of freed storage, one per type, shared by everything allocating through a context.
+/**
+ * It is a sub context, so there is one per context, which every publisher and
+ * subscription using a MessagePoolAllocator of that context draws from.
+ * A message freed by one component is handed out again to the next component
+ * allocating the same type, instead of going back to the heap.
+ *
+ * Each pool keeps at most get_max_cached_blocks() free blocks, beyond which
+ * they are freed, so bursts don't pin memory forever.
+ * Types beyond the first max_type_slots allocated through any registry are
+ * not pooled.
+ */
+class MessagePoolRegistry
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(MessagePoolRegistry)
+
+  /// Number of distinct types which can be pooled in a process.
+  static constexpr size_t max_type_slots = 256;
+
+  /// Slot for blocks which are not pooled.
+  static constexpr size_t unpooled_slot = max_type_slots;
+
+  RCLCPP_PUBLIC
+  MessagePoolRegistry();
+
+  RCLCPP_PUBLIC
+  virtual ~MessagePoolRegistry();
+
+  /// Return the slot of a type, which is the same for every registry.
+  template<typename T>
+  static size_t
+  type_slot()
+  {
+    static const size_t slot = next_type_slot();
+    return slot;
+  }
+
+  /// Take a free block of the type in the slot, or allocate one with operator new.
+  RCLCPP_PUBLIC
+  void *
+  allocate(size_t slot, size_t size, size_t alignment);
+
+  /// Keep the block for the next allocation of the type in the slot, or free it.
+  RCLCPP_PUBLIC
+  void
+  deallocate(void * pointer, size_t slot, size_t alignment);
+
+  /// Set how many free blocks each pool keeps at most.
+  RCLCPP_PUBLIC
+  void
+  set_max_cached_blocks(size_t max_cached_blocks);
+
+  RCLCPP_PUBLIC
+  size_t
+  get_max_cached_blocks() const;
+
+private:
+  struct Pool
+  {
+    std::mutex mutex;
+    std::vector<void *> free_blocks;
+  };
+
+  RCLCPP_PUBLIC
+  static size_t
+  next_type_slot();
+
+  Pool *
+  get_pool(size_t slot);
+
+  std::array<std::atomic<Pool *>, max_type_slots> pools_;
+  std::atomic_size_t max_cached_blocks_;
+};
+
+/// Return the message pool registry of a context.
+inline
+MessagePoolRegistry::SharedPtr
+get_message_pool_registry(rclcpp::Context::SharedPtr context)
+{
+  return context->get_sub_context<MessagePoolRegistry>();
+}
+
+/// Allocator drawing single objects from the per-type pools of a MessagePoolRegistry.
+/**
+ * Pass it in the publisher or subscription options of every component which
+ * should share message storage, e.g.:
+ *
+ * \code
+ * rclcpp::PublisherOptionsWithAllocator<MessagePoolAllocator<void>> options;
+ * options.allocator = std::make_shared<MessagePoolAllocator<void>>(
+ *   get_message_pool_registry(node->get_node_base_interface()->get_context()));
+ * \endcode
+ *
+ * Messages allocated for publishing, including the fallback of
+ * borrow_loaned_message() and intra-process copies, and messages taken by
+ * subscriptions then come from the pool of their type.
+ * Arrays of several objects are not pooled.
+ * A default constructed allocator uses the registry of the global default context.
+ */
+template<typename T>
+class MessagePoolAllocator
+{
+public:
+  using value_type = T;
+
+  MessagePoolAllocator()
+  : registry_(get_message_pool_registry(rclcpp::contexts::get_global_default_context()))
+  {}
+
+  explicit MessagePoolAllocator(MessagePoolRegistry::SharedPtr registry)
+  : registry_(std::move(registry))
+  {}
+
+  template<typename U>
+  MessagePoolAllocator(const MessagePoolAllocator<U> & other) noexcept
+  : registry_(other.get_registry())
+  {}
+
+  T *
+  allocate(size_t n)
+  {
+    if (1 == n) {
+      return static_cast<T *>(
+        registry_->allocate(MessagePoolRegistry::type_slot<T>(), sizeof(T), alignof(T)));
+    }
+    // Never smaller than one object, so any block may be pooled when deallocated.
+    return static_cast<T *>(
+      registry_->allocate(
+        MessagePoolRegistry::unpooled_slot, std::max<size_t>(n, 1) * sizeof(T), alignof(T)));
+  }
+
+  void
+  deallocate(T * pointer, size_t n)
+  {
+    registry_->deallocate(
+      pointer,
+      1 == n ? MessagePoolRegistry::type_slot<T>() : MessagePoolRegistry::unpooled_slot,
+      alignof(T));
+  }
+
+  const MessagePoolRegistry::SharedPtr &
+  get_registry() const
+  {
+    return registry_;
+  }
+
+private:
+  MessagePoolRegistry::SharedPtr registry_;
+};
+
+template<typename T, typename U>
+bool
+operator==(const MessagePoolAllocator<T> & a, const MessagePoolAllocator<U> & b)
+{
+  return a.get_registry() == b.get_registry();
+}
+
+template<typename T, typename U>
+bool
+operator!=(const MessagePoolAllocator<T> & a, const MessagePoolAllocator<U> & b)
+{
+  return !(a == b);
+}
+
+}  // namespace allocator
+}  // namespace rclcpp
+
+#endif  // RCLCPP__ALLOCATOR__MESSAGE_POOL_ALLOCATOR_HPP_
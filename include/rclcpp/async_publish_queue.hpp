@@ -0,0 +1,179 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__ASYNC_PUBLISH_QUEUE_HPP_
+#define RCLCPP__ASYNC_PUBLISH_QUEUE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "rcl/publisher.h"
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// What to do with a message published while the asynchronous publish queue is full.
+enum class AsyncPublishOverflowPolicy
+{
+  /// Drop the oldest queued message to make room for the new one.
+  DropOldest,
+  /// Drop the new message.
+  DropNewest,
+  /// Wait on the publishing thread until there is room, as a synchronous publish would.
+  Block,
+};
+
+/// Options of the asynchronous inter-process publishes of a publisher.
+struct AsyncPublishOptions
+{
+  /// Publish inter-process on a background thread, disabled by default.
+  bool enabled = false;
+  /// Number of messages which can wait to be published.
+  size_t capacity = 64;
+  /// What to do when the queue is full.
+  AsyncPublishOverflowPolicy overflow_policy = AsyncPublishOverflowPolicy::DropOldest;
+};
+
+/// Metrics of an AsyncPublishQueue.
+struct AsyncPublishStatistics
+{
+  /// Number of messages waiting to be published.
+  size_t queue_depth;
+  /// Largest number of messages waiting to be published at once.
+  size_t max_queue_depth;
+  /// Number of messages published.
+  uint64_t published_count;
+  /// Number of messages dropped because the queue was full.
+  uint64_t dropped_count;
+  /// Number of messages the middleware failed to publish.
+  uint64_t failed_count;
+  /// Time from queueing to the end of rcl_publish, for the last published message.
+  std::chrono::nanoseconds last_latency;
+  /// Mean of the above, over the published messages.
+  std::chrono::nanoseconds mean_latency;
+  /// Largest of the above, over the published messages.
+  std::chrono::nanoseconds max_latency;
+};
+
+/// Bounded queue of ROS messages published inter-process by a background thread.
+/**
+ * Publishers created with an enabled AsyncPublishOptions give it their inter-process
+ * publishes, so a middleware which is slow to publish doesn't stall the publishing
+ * thread.
+ *
+ * The queue is a lock-free ring buffer which any number of threads may push into.
+ * The background thread publishes the messages in order, and only sleeps, on a
+ * condition variable, when the queue is empty.
+ * With AsyncPublishOverflowPolicy::Block, threads pushing into a full queue sleep on another
+ * condition variable, until the background thread takes a message out of the queue.
+ * Errors of rcl_publish() are logged and counted, as there is nobody to throw them to.
+ */
+class AsyncPublishQueue
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(AsyncPublishQueue)
+
+  /// Start the publishing thread.
+  /**
+   * \param[in] publisher_handle The rcl publisher of the messages, kept alive by the queue.
+   * \param[in] options The capacity and overflow policy of the queue.
+   * \throws std::invalid_argument if the capacity is zero.
+   */
+  RCLCPP_PUBLIC
+  AsyncPublishQueue(
+    std::shared_ptr<rcl_publisher_t> publisher_handle,
+    const AsyncPublishOptions & options);
+
+  /// Publish the queued messages and stop the publishing thread.
+  RCLCPP_PUBLIC
+  virtual ~AsyncPublishQueue();
+
+  /// Queue a ROS message to be published.
+  /**
+   * \param[in] ros_message The message, which must not be modified anymore.
+   * \return false if the message was dropped, as the queue is full.
+   */
+  RCLCPP_PUBLIC
+  bool
+  push(std::shared_ptr<const void> ros_message);
+
+  /// Get the metrics of the queue.
+  RCLCPP_PUBLIC
+  AsyncPublishStatistics
+  get_statistics() const;
+
+private:
+  RCLCPP_DISABLE_COPY(AsyncPublishQueue)
+
+  struct Slot
+  {
+    std::atomic<size_t> sequence;
+    std::shared_ptr<const void> ros_message;
+    std::chrono::steady_clock::time_point queued_time;
+  };
+
+  size_t
+  get_depth() const;
+
+  bool
+  try_push(std::shared_ptr<const void> & ros_message);
+
+  bool
+  try_pop(std::shared_ptr<const void> & ros_message, std::chrono::steady_clock::time_point & time);
+
+  void
+  wait_for_room();
+
+  void
+  run();
+
+  void
+  publish(const void * ros_message, std::chrono::steady_clock::time_point queued_time);
+
+  std::shared_ptr<rcl_publisher_t> publisher_handle_;
+  const AsyncPublishOverflowPolicy overflow_policy_;
+  const size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<size_t> enqueue_position_{0};
+  std::atomic<size_t> dequeue_position_{0};
+
+  std::atomic<size_t> max_depth_{0};
+  std::atomic<uint64_t> published_count_{0};
+  std::atomic<uint64_t> dropped_count_{0};
+  std::atomic<uint64_t> failed_count_{0};
+  std::atomic<int64_t> last_latency_ns_{0};
+  std::atomic<int64_t> total_latency_ns_{0};
+  std::atomic<int64_t> max_latency_ns_{0};
+
+  std::mutex wake_mutex_;
+  std::condition_variable wake_condition_;
+  std::atomic<bool> sleeping_{false};
+  std::condition_variable room_condition_;
+  std::atomic<size_t> blocked_producers_{0};
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__ASYNC_PUBLISH_QUEUE_HPP_
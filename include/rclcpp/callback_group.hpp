@@ -16,6 +16,8 @@
 #define RCLCPP__CALLBACK_GROUP_HPP_
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -178,6 +180,45 @@ public:
   bool
   automatically_add_to_executor_with_node() const;
 
+  /// Set how long a callback of this group is expected to execute at most.
+  /**
+   * Executors measure the execution time of the callbacks of a group with a budget, and
+   * count those exceeding it as overruns.
+   * This is meant to catch a callback starving the ones of higher priority, not to enforce
+   * the budget: an overrunning callback is not interrupted.
+   *
+   * \param[in] budget the execution budget, or zero (the default) to not measure callbacks.
+   * \sa rclcpp::Executor::set_overrun_callback
+   */
+  RCLCPP_PUBLIC
+  void
+  set_execution_budget(std::chrono::nanoseconds budget);
+
+  /// Return the execution budget of the callbacks of this group, zero if there is none.
+  RCLCPP_PUBLIC
+  std::chrono::nanoseconds
+  get_execution_budget() const;
+
+  /// Return how many callbacks of this group exceeded the execution budget.
+  RCLCPP_PUBLIC
+  uint64_t
+  get_overrun_count() const;
+
+  /// Return the longest execution time of a callback of this group that exceeded the budget.
+  RCLCPP_PUBLIC
+  std::chrono::nanoseconds
+  get_worst_overrun_execution_time() const;
+
+  /// Count an execution of a callback of this group that exceeded the budget.
+  /**
+   * This is called by executors.
+   *
+   * \param[in] execution_time how long the callback executed.
+   */
+  RCLCPP_PUBLIC
+  void
+  record_overrun(std::chrono::nanoseconds execution_time);
+
   /// Defer creating the notify guard condition and return it.
   RCLCPP_PUBLIC
   rclcpp::GuardCondition::SharedPtr
@@ -233,6 +274,10 @@ protected:
   // defer the creation of the guard condition
   std::shared_ptr<rclcpp::GuardCondition> notify_guard_condition_ = nullptr;
   std::recursive_mutex notify_guard_condition_mutex_;
+  // Execution budget and overrun statistics, in nanoseconds.
+  std::atomic<int64_t> execution_budget_ns_{0};
+  std::atomic<uint64_t> overrun_count_{0};
+  std::atomic<int64_t> worst_overrun_execution_time_ns_{0};
 
 private:
   template<typename TypeT, typename Function>
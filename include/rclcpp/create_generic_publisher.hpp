@@ -39,7 +39,8 @@ namespace rclcpp
  * \param qos %QoS settings
  * \param options %Publisher options.
  * Not all publisher options are currently respected, the only relevant options for this
- * publisher are `event_callbacks`, `use_default_callbacks`, and `%callback_group`.
+ * publisher are `event_callbacks`, `use_default_callbacks`, `use_intra_process_comm`,
+ * and `%callback_group`.
  */
 template<typename AllocatorT = std::allocator<void>>
 std::shared_ptr<GenericPublisher> create_generic_publisher(
@@ -60,6 +61,7 @@ std::shared_ptr<GenericPublisher> create_generic_publisher(
     topic_type,
     qos,
     options);
+  pub->post_init_setup(topics_interface->get_node_base_interface(), qos, options);
   topics_interface->add_publisher(pub, options.callback_group);
   return pub;
 }
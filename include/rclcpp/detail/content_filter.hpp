@@ -0,0 +1,111 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__DETAIL__CONTENT_FILTER_HPP_
+#define RCLCPP__DETAIL__CONTENT_FILTER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rosidl_runtime_c/message_type_support_struct.h"
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Content filter expression compiled into a predicate over typed ROS messages.
+/**
+ * This is the client side counterpart of the content filtered topics of the middleware,
+ * used for the messages which never go through it, like the intra-process ones.
+ *
+ * The supported grammar is the subset of the DDS content filter one used with ROS 2:
+ *   - comparisons `=`, `<>`, `!=`, `<`, `<=`, `>`, `>=` and `LIKE`,
+ *   - `BETWEEN` and `NOT BETWEEN`,
+ *   - `AND`, `OR`, `NOT` and parentheses,
+ *   - integer, floating point, boolean (`TRUE`, `FALSE`) and quoted string literals,
+ *   - parameters `%0` to `%99`, replaced by the given expression parameters.
+ *
+ * Operands are either literals or fields of the message, nested fields are separated
+ * by dots, e.g. `header.frame_id = 'map' AND position.x > %0`.
+ * Only single (non array) fields holding a number, a boolean or a string are supported.
+ *
+ * Field names are resolved to offsets in the message once, when the filter is compiled,
+ * so evaluating it doesn't look anything up.
+ */
+class ContentFilter
+{
+public:
+  /// Compile a filter expression for the messages of the given type.
+  /**
+   * \param[in] type_support The type support of the messages, for any type support
+   *   which can provide the rosidl_typesupport_introspection_cpp one.
+   * \param[in] filter_expression The filter expression.
+   * \param[in] expression_parameters The values of the parameters in the expression.
+   * \throws std::invalid_argument if the expression is invalid or uses unsupported
+   *   features, or if the introspection type support is not available.
+   */
+  RCLCPP_PUBLIC
+  ContentFilter(
+    const rosidl_message_type_support_t & type_support,
+    const std::string & filter_expression,
+    const std::vector<std::string> & expression_parameters = {});
+
+  RCLCPP_PUBLIC
+  ~ContentFilter();
+
+  /// Return true if the message matches the filter.
+  /**
+   * \param[in] ros_message A message of the type the filter was compiled for.
+   */
+  RCLCPP_PUBLIC
+  bool
+  evaluate(const void * ros_message) const;
+
+  /// Get the expression the filter was compiled from.
+  RCLCPP_PUBLIC
+  const std::string &
+  get_filter_expression() const;
+
+  /// Get the parameters the filter was compiled with.
+  RCLCPP_PUBLIC
+  const std::vector<std::string> &
+  get_expression_parameters() const;
+
+private:
+  RCLCPP_DISABLE_COPY(ContentFilter)
+
+  friend class ContentFilterParser;
+  struct Operand;
+  struct Node;
+
+  bool
+  evaluate_node(size_t index, const void * ros_message) const;
+
+  std::string filter_expression_;
+  std::vector<std::string> expression_parameters_;
+  std::vector<Node> nodes_;
+  size_t root_;
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__CONTENT_FILTER_HPP_
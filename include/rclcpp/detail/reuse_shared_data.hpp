@@ -0,0 +1,57 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__DETAIL__REUSE_SHARED_DATA_HPP_
+#define RCLCPP__DETAIL__REUSE_SHARED_DATA_HPP_
+
+#include <atomic>
+#include <memory>
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Return the data held by slot if nobody else owns it, otherwise newly allocated data.
+/**
+ * This is used by waitables to hand data from take_data() to execute() without allocating
+ * on every take.
+ * The data in the slot is only reused once every previous owner released it, so it is safe
+ * when an executor holds the data of several takes at once.
+ * Calls for the same slot must not be concurrent, which holds for take_data() since the
+ * executors serialize it.
+ *
+ * \param[inout] slot the shared pointer keeping the reusable data, allocated on first use.
+ * \return a shared pointer to data that is not owned by anybody else.
+ */
+template<typename DataT>
+std::shared_ptr<DataT>
+reuse_shared_data(std::shared_ptr<DataT> & slot)
+{
+  if (!slot) {
+    slot = std::make_shared<DataT>();
+    return slot;
+  }
+  if (slot.use_count() == 1) {
+    // Synchronize with the release of the last other owner, before the data is written again.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot;
+  }
+  return std::make_shared<DataT>();
+}
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__REUSE_SHARED_DATA_HPP_
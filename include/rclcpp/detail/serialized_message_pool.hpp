@@ -0,0 +1,64 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__DETAIL__SERIALIZED_MESSAGE_POOL_HPP_
+#define RCLCPP__DETAIL__SERIALIZED_MESSAGE_POOL_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Recycle serialized messages, keeping the capacity of their buffers.
+/**
+ * The messages handed out go back to the pool when their last reference is dropped,
+ * even if that happens on another thread or after the user kept them for a while.
+ * Only up to max_cached messages are kept, the others are destroyed.
+ * The pool must be owned by a std::shared_ptr, messages outliving it are destroyed.
+ */
+class SerializedMessagePool : public std::enable_shared_from_this<SerializedMessagePool>
+{
+public:
+  RCLCPP_PUBLIC
+  explicit SerializedMessagePool(size_t max_cached = 16);
+
+  RCLCPP_PUBLIC
+  ~SerializedMessagePool();
+
+  /// Get an empty message with at least the given capacity.
+  RCLCPP_PUBLIC
+  std::shared_ptr<rclcpp::SerializedMessage>
+  acquire(size_t capacity = 0u);
+
+private:
+  void
+  recycle(rclcpp::SerializedMessage * message);
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<rclcpp::SerializedMessage>> free_messages_;
+  const size_t max_cached_;
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__SERIALIZED_MESSAGE_POOL_HPP_
@@ -0,0 +1,92 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__DETAIL__WAIT_WITH_POLICY_HPP_
+#define RCLCPP__DETAIL__WAIT_WITH_POLICY_HPP_
+
+#include <algorithm>
+#include <chrono>
+
+#include "rcl/wait.h"
+
+#include "rclcpp/executor_options.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Wait on an already filled wait set, polling it first as the wait policy asks.
+/**
+ * Every non-blocking rcl_wait() that finds nothing ready leaves all entries of the wait set
+ * null, so refill is called to clear the wait set and add the same entities again before the
+ * next wait.
+ * Intra-process subscriptions and interrupts are noticed while polling through the guard
+ * conditions they trigger.
+ *
+ * \param[in] wait_set the wait set to wait on, filled with the entities to wait for.
+ * \param[in] timeout the time to wait for, negative to wait forever.
+ * \param[in] policy how to wait, see rclcpp::ExecutorWaitPolicy.
+ * \param[in] busy_poll_duration how long to poll before blocking with SpinThenBlock.
+ * \param[in] refill callable clearing and filling the wait set again.
+ * \return the return code of the last rcl_wait().
+ */
+template<typename RefillT>
+rcl_ret_t
+wait_with_policy(
+  rcl_wait_set_t * wait_set,
+  std::chrono::nanoseconds timeout,
+  ExecutorWaitPolicy policy,
+  std::chrono::nanoseconds busy_poll_duration,
+  RefillT && refill)
+{
+  if (policy == ExecutorWaitPolicy::Block || timeout == std::chrono::nanoseconds::zero()) {
+    return rcl_wait(wait_set, timeout.count());
+  }
+
+  // A negative poll duration polls until something is ready.
+  std::chrono::nanoseconds poll_duration = timeout;
+  if (policy == ExecutorWaitPolicy::SpinThenBlock) {
+    poll_duration = timeout < std::chrono::nanoseconds::zero() ?
+      busy_poll_duration : std::min(busy_poll_duration, timeout);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  std::chrono::nanoseconds elapsed(0);
+  while (true) {
+    rcl_ret_t status = rcl_wait(wait_set, 0);
+    if (status != RCL_RET_TIMEOUT) {
+      return status;
+    }
+    elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+    if (poll_duration >= std::chrono::nanoseconds::zero() && elapsed >= poll_duration) {
+      break;
+    }
+    refill();
+  }
+
+  // The wait set is left empty on timeout, as a blocking rcl_wait() would leave it.
+  const bool blocking = timeout < std::chrono::nanoseconds::zero();
+  if (policy == ExecutorWaitPolicy::BusyPoll || (!blocking && elapsed >= timeout)) {
+    return RCL_RET_TIMEOUT;
+  }
+  refill();
+  return rcl_wait(wait_set, blocking ? -1 : (timeout - elapsed).count());
+}
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__WAIT_WITH_POLICY_HPP_
@@ -19,6 +19,7 @@
 #include <cassert>
 #include <chrono>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <list>
 #include <map>
@@ -34,6 +35,7 @@
 #include "rclcpp/context.hpp"
 #include "rclcpp/contexts/default_context.hpp"
 #include "rclcpp/guard_condition.hpp"
+#include "rclcpp/executor_arena.hpp"
 #include "rclcpp/executor_options.hpp"
 #include "rclcpp/future_return_code.hpp"
 #include "rclcpp/memory_strategies.hpp"
@@ -403,6 +405,32 @@ public:
   void
   set_memory_strategy(memory_strategy::MemoryStrategy::SharedPtr memory_strategy);
 
+  /// Return the number of bytes the executor took from the region of its arena.
+  /**
+   * \return the high-water mark of rclcpp::ExecutorOptions::arena, or 0 if it wasn't set.
+   */
+  RCLCPP_PUBLIC
+  size_t
+  get_memory_high_water_mark() const;
+
+  /// Type of the callback called when a callback exceeds the execution budget of its group.
+  using OverrunCallbackType =
+    std::function<void (const AnyExecutable &, std::chrono::nanoseconds)>;
+
+  /// Set a callback called when a callback exceeds the execution budget of its group.
+  /**
+   * The callback is called by the thread which executed the overrunning callback, right after
+   * it, with the executable and its execution time.
+   * The overrun is counted in the callback group beforehand, see
+   * rclcpp::CallbackGroup::set_execution_budget().
+   * This must not be called while the executor is spinning.
+   *
+   * \param[in] callback the callback to call, or nullptr to only count overruns.
+   */
+  RCLCPP_PUBLIC
+  void
+  set_overrun_callback(OverrunCallbackType callback);
+
 #ifdef PICAS
   bool callback_priority_enabled = false;
   int executor_priority = 0;
@@ -478,6 +506,22 @@ RCLCPP_PUBLIC
   {
     if (ptr) ptr->callback_priority = priority;
   }
+
+  /// Lower the callback_priority of callbacks exceeding their execution budget.
+  /**
+   * An overrunning entity with a higher priority gets the given priority, so that it can't
+   * starve the callbacks of higher priority again.
+   * This must not be called while the executor is spinning.
+   *
+   * \param[in] priority the priority given to overrunning entities.
+   */
+  RCLCPP_PUBLIC
+  void
+  set_overrun_demotion_priority(int priority)
+  {
+    demote_priority_on_overrun_ = true;
+    overrun_demotion_priority_ = priority;
+  }
 #endif
 
   /// Returns true if the executor is currently spinning.
@@ -496,6 +540,11 @@ protected:
   print_list_ready_executable(AnyExecutable & any_executable);
 #endif
 
+  /// Count an overrun of the executable and report it as configured.
+  RCLCPP_PUBLIC
+  void
+  handle_overrun(const AnyExecutable & any_exec, std::chrono::nanoseconds execution_time);
+
   RCLCPP_PUBLIC
   void
   spin_node_once_nanoseconds(
@@ -521,6 +570,19 @@ protected:
   execute_subscription(
     rclcpp::SubscriptionBase::SharedPtr subscription);
 
+  /// Take a message from the subscription and handle it.
+  /**
+   * \param[in] subscription the subscription to take the message from.
+   * \param[in] use_receive_message if true, the message is taken into the subscription's
+   *   receive message, see rclcpp::SubscriptionBase::borrow_receive_message(), rather than
+   *   into a newly created message.
+   */
+  RCLCPP_PUBLIC
+  static void
+  execute_subscription(
+    const rclcpp::SubscriptionBase::SharedPtr & subscription,
+    bool use_receive_message);
+
   RCLCPP_PUBLIC
   static void
   execute_timer(rclcpp::TimerBase::SharedPtr timer);
@@ -624,6 +686,19 @@ protected:
 
   std::shared_ptr<rclcpp::GuardCondition> shutdown_guard_condition_;
 
+  /// Arena to allocate from, if any, declared first so it outlives what is allocated from it.
+  /**
+   * \sa rclcpp::ExecutorOptions::arena
+   */
+  const std::shared_ptr<rclcpp::ExecutorArena> arena_;
+
+  /// Allocator of the arena, or of the default memory resource without one.
+  /**
+   * The wait set keeps a pointer to it, so it is owned by the executor rather than
+   * the memory strategy, which can be replaced.
+   */
+  rclcpp::ExecutorArena::Allocator<char> arena_allocator_;
+
   /// Wait set for managing entities that the rmw layer waits on.
   rcl_wait_set_t wait_set_ = rcl_get_zero_initialized_wait_set();
 
@@ -637,6 +712,36 @@ protected:
   /// The context associated with this executor.
   std::shared_ptr<rclcpp::Context> context_;
 
+  /// Whether messages are taken into storage preallocated per subscription.
+  /**
+   * \sa rclcpp::ExecutorOptions::preallocate_messages
+   */
+  const bool preallocate_messages_;
+
+  /// How to wait for work.
+  /**
+   * \sa rclcpp::ExecutorOptions::wait_policy
+   */
+  const ExecutorWaitPolicy wait_policy_;
+
+  /// How long to poll before blocking with ExecutorWaitPolicy::SpinThenBlock.
+  const std::chrono::nanoseconds busy_poll_duration_;
+
+  /// Whether the memory strategy waits on steady clock timers by deadline.
+  /**
+   * \sa rclcpp::ExecutorOptions::use_timer_queue
+   */
+  bool use_timer_queue_;
+
+  /// Called when a callback exceeds the execution budget of its group.
+  OverrunCallbackType overrun_callback_;
+
+#ifdef PICAS
+  /// Whether overrunning entities get overrun_demotion_priority_ as callback_priority.
+  bool demote_priority_on_overrun_ = false;
+  int overrun_demotion_priority_ = 0;
+#endif
+
   RCLCPP_DISABLE_COPY(Executor)
 
   RCLCPP_PUBLIC
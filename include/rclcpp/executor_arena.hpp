@@ -0,0 +1,154 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXECUTOR_ARENA_HPP_
+#define RCLCPP__EXECUTOR_ARENA_HPP_
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Preallocated memory region which an executor and its memory strategy allocate from.
+/**
+ * The region is allocated once, at construction, and carved up monotonically.
+ * Freed blocks are kept in pools by size and reused by later allocations, so
+ * a steady-state spin, which frees what it allocated in the previous
+ * iteration, stays within the region.
+ * Blocks larger than the pools handle, e.g. the arrays of a large rcl wait set,
+ * are rounded up to a power of two and kept in free lists of their own.
+ *
+ * Once the region is exhausted, further memory is taken from the heap if
+ * growth is allowed, otherwise std::bad_alloc is thrown.
+ * The high-water mark tells how much of the region a workload needs, and so
+ * how large to make it.
+ *
+ * It is safe to allocate from several threads, e.g. in a MultiThreadedExecutor.
+ * The arena must outlive everything allocated from it, see
+ * rclcpp::memory_strategies::create_arena_strategy().
+ */
+class ExecutorArena : public std::pmr::memory_resource
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(ExecutorArena)
+
+  /// Allocator for containers allocating from the arena.
+  template<typename T>
+  using Allocator = std::pmr::polymorphic_allocator<T>;
+
+  /// Preallocate the region.
+  /**
+   * The pools take memory from the region in chunks of growing size, so the
+   * region needs to be comfortably larger than the high-water mark.
+   *
+   * \param[in] capacity the size of the region in bytes.
+   * \param[in] allow_growth whether to fall back to the heap once the region is exhausted.
+   */
+  RCLCPP_PUBLIC
+  explicit ExecutorArena(size_t capacity, bool allow_growth = true);
+
+  RCLCPP_PUBLIC
+  ~ExecutorArena() override;
+
+  /// Return the size of the preallocated region in bytes.
+  RCLCPP_PUBLIC
+  size_t
+  get_capacity() const;
+
+  /// Return the number of bytes currently allocated from the arena.
+  RCLCPP_PUBLIC
+  size_t
+  get_bytes_in_use() const;
+
+  /// Return the number of bytes taken from the region.
+  /**
+   * Memory taken from the region is only reused by the arena, never given back,
+   * so this is the peak use of the region, including the chunks the pools keep
+   * for reuse and the rounding of large blocks.
+   * Once it exceeds get_capacity(), the rest came from the heap.
+   */
+  RCLCPP_PUBLIC
+  size_t
+  get_high_water_mark() const;
+
+protected:
+  RCLCPP_PUBLIC
+  void *
+  do_allocate(size_t bytes, size_t alignment) override;
+
+  RCLCPP_PUBLIC
+  void
+  do_deallocate(void * pointer, size_t bytes, size_t alignment) override;
+
+  RCLCPP_PUBLIC
+  bool
+  do_is_equal(const std::pmr::memory_resource & other) const noexcept override;
+
+private:
+  /// Upstream of the pools, counting the bytes they take from the region.
+  class RegionUsage : public std::pmr::memory_resource
+  {
+public:
+    explicit RegionUsage(std::pmr::memory_resource * region);
+
+    size_t bytes_taken = 0;
+
+protected:
+    void *
+    do_allocate(size_t bytes, size_t alignment) override;
+
+    void
+    do_deallocate(void * pointer, size_t bytes, size_t alignment) override;
+
+    bool
+    do_is_equal(const std::pmr::memory_resource & other) const noexcept override;
+
+private:
+    std::pmr::memory_resource * region_;
+  };
+
+  struct FreeBlock
+  {
+    FreeBlock * next;
+  };
+
+  void *
+  allocate_large_block(size_t bytes, size_t alignment);
+
+  void
+  deallocate_large_block(void * pointer, size_t bytes);
+
+  const size_t capacity_;
+  std::unique_ptr<std::byte[]> buffer_;
+  std::pmr::monotonic_buffer_resource region_;
+  RegionUsage region_usage_;
+  std::pmr::unsynchronized_pool_resource pools_;
+  size_t largest_pool_block_;
+  // Free large blocks, by the log2 of their size.
+  std::array<FreeBlock *, sizeof(size_t) * 8> free_large_blocks_{};
+
+  mutable std::mutex mutex_;
+  size_t bytes_in_use_ = 0;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXECUTOR_ARENA_HPP_
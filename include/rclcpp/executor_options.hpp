@@ -15,8 +15,12 @@
 #ifndef RCLCPP__EXECUTOR_OPTIONS_HPP_
 #define RCLCPP__EXECUTOR_OPTIONS_HPP_
 
+#include <chrono>
+#include <memory>
+
 #include "rclcpp/context.hpp"
 #include "rclcpp/contexts/default_context.hpp"
+#include "rclcpp/executor_arena.hpp"
 #include "rclcpp/memory_strategies.hpp"
 #include "rclcpp/memory_strategy.hpp"
 #include "rclcpp/visibility_control.hpp"
@@ -24,18 +28,75 @@
 namespace rclcpp
 {
 
+/// How an executor waits for work once nothing is ready.
+enum class ExecutorWaitPolicy
+{
+  /// Block in the middleware until an entity is ready or the timeout expires.
+  Block,
+  /// Poll without blocking for ExecutorOptions::busy_poll_duration, then block.
+  SpinThenBlock,
+  /// Poll without blocking until an entity is ready or the timeout expires, never block.
+  BusyPoll,
+};
+
 /// Options to be passed to the executor constructor.
 struct ExecutorOptions
 {
   ExecutorOptions()
   : memory_strategy(rclcpp::memory_strategies::create_default_strategy()),
     context(rclcpp::contexts::get_global_default_context()),
-    max_conditions(0)
+    max_conditions(0),
+    preallocate_messages(false),
+    wait_policy(ExecutorWaitPolicy::Block),
+    busy_poll_duration(std::chrono::microseconds(50)),
+    use_timer_queue(false)
   {}
 
   rclcpp::memory_strategy::MemoryStrategy::SharedPtr memory_strategy;
   rclcpp::Context::SharedPtr context;
   size_t max_conditions;
+
+  /// Take inter-process messages into storage preallocated per subscription.
+  /**
+   * When true, each subscription keeps the message it last took and reuses it for the next
+   * take instead of creating a new one, so spinning does not allocate in steady state.
+   * This trades the memory of one message per subscription for allocation-free takes.
+   * It applies to both typed and serialized messages.
+   */
+  bool preallocate_messages;
+
+  /// How the executor waits for work, see rclcpp::ExecutorWaitPolicy.
+  /**
+   * Polling avoids the sleep and wake-up latency of a blocking wait, which dominates when
+   * messages arrive in bursts or through intra-process communication, at the cost of keeping
+   * a core busy while idle.
+   */
+  ExecutorWaitPolicy wait_policy;
+
+  /// How long to poll before blocking, when wait_policy is ExecutorWaitPolicy::SpinThenBlock.
+  std::chrono::nanoseconds busy_poll_duration;
+
+  /// Wait on steady clock timers by deadline rather than through the wait set.
+  /**
+   * The memory strategy keeps these timers in a queue ordered by deadline, the executor
+   * waits until the earliest one is due and only the due timers are checked after the wait.
+   * This pays off with many timers, most of which are not due at each wake up.
+   * The memory strategy must support it, see
+   * rclcpp::memory_strategy::MemoryStrategy::set_timer_queue_enabled().
+   * It is ignored by the StaticSingleThreadedExecutor.
+   */
+  bool use_timer_queue;
+
+  /// Arena from which the executor allocates while spinning, if not null.
+  /**
+   * When set, the executor replaces memory_strategy with one created by
+   * rclcpp::memory_strategies::create_arena_strategy(), so its collected
+   * handles, wait set and the temporaries of each spin come from the arena.
+   * The executor keeps the arena alive and reports its high-water mark, see
+   * rclcpp::Executor::get_memory_high_water_mark().
+   * Messages are not allocated from it, see preallocate_messages for those.
+   */
+  std::shared_ptr<rclcpp::ExecutorArena> arena;
 };
 
 }  // namespace rclcpp
@@ -24,6 +24,7 @@
 #include "rcl/guard_condition.h"
 #include "rcl/wait.h"
 
+#include "rclcpp/executor_options.hpp"
 #include "rclcpp/experimental/executable_list.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/memory_strategy.hpp"
@@ -38,6 +39,13 @@ typedef std::map<rclcpp::CallbackGroup::WeakPtr,
     rclcpp::node_interfaces::NodeBaseInterface::WeakPtr,
     std::owner_less<rclcpp::CallbackGroup::WeakPtr>> WeakCallbackGroupsToNodesMap;
 
+/// Waitable collecting the entities of a StaticSingleThreadedExecutor.
+/**
+ * The entities are only collected, and their weak pointers locked, when it is
+ * executed because entities were added or removed.
+ * In between, the executor spins over the executable list filled by the last
+ * collection, without locking any weak pointer.
+ */
 class StaticExecutorEntitiesCollector final
   : public rclcpp::Waitable,
   public std::enable_shared_from_this<StaticExecutorEntitiesCollector>
@@ -57,13 +65,16 @@ public:
   /**
    * \param p_wait_set A reference to the wait set to be used in the executor
    * \param memory_strategy Shared pointer to the memory strategy to set.
+   * \param preallocate_messages If true, the receive message of each collected subscription
+   *   is allocated when the executable list is filled rather than on the first take.
    * \throws std::runtime_error if memory strategy is null
    */
   RCLCPP_PUBLIC
   void
   init(
     rcl_wait_set_t * p_wait_set,
-    rclcpp::memory_strategy::MemoryStrategy::SharedPtr memory_strategy);
+    rclcpp::memory_strategy::MemoryStrategy::SharedPtr memory_strategy,
+    bool preallocate_messages = false);
 
   /// Finalize StaticExecutorEntitiesCollector to clear resources
   RCLCPP_PUBLIC
@@ -98,6 +109,13 @@ public:
   void
   refresh_wait_set(std::chrono::nanoseconds timeout = std::chrono::nanoseconds(-1));
 
+  /// Set how refresh_wait_set() waits, see rclcpp::ExecutorWaitPolicy.
+  RCLCPP_PUBLIC
+  void
+  set_wait_policy(
+    rclcpp::ExecutorWaitPolicy wait_policy,
+    std::chrono::nanoseconds busy_poll_duration);
+
   /**
    * \throws std::runtime_error if it couldn't add guard condition to wait set
    */
@@ -244,7 +262,7 @@ public:
    * \throws std::out_of_range if the argument is higher than the size of the structrue.
    */
   RCLCPP_PUBLIC
-  rclcpp::SubscriptionBase::SharedPtr
+  const rclcpp::SubscriptionBase::SharedPtr &
   get_subscription(size_t i) {return exec_list_.subscription[i];}
 
   /** Return a TimerBase Sharedptr by index.
@@ -253,7 +271,7 @@ public:
    * \throws std::out_of_range if the argument is higher than the size.
    */
   RCLCPP_PUBLIC
-  rclcpp::TimerBase::SharedPtr
+  const rclcpp::TimerBase::SharedPtr &
   get_timer(size_t i) {return exec_list_.timer[i];}
 
   /** Return a ServiceBase Sharedptr by index.
@@ -262,7 +280,7 @@ public:
    * \throws std::out_of_range if the argument is higher than the size.
    */
   RCLCPP_PUBLIC
-  rclcpp::ServiceBase::SharedPtr
+  const rclcpp::ServiceBase::SharedPtr &
   get_service(size_t i) {return exec_list_.service[i];}
 
   /** Return a ClientBase Sharedptr by index
@@ -271,7 +289,7 @@ public:
    * \throws std::out_of_range if the argument is higher than the size.
    */
   RCLCPP_PUBLIC
-  rclcpp::ClientBase::SharedPtr
+  const rclcpp::ClientBase::SharedPtr &
   get_client(size_t i) {return exec_list_.client[i];}
 
   /** Return a Waitable Sharedptr by index
@@ -280,7 +298,7 @@ public:
    * \throws std::out_of_range if the argument is higher than the size.
    */
   RCLCPP_PUBLIC
-  rclcpp::Waitable::SharedPtr
+  const rclcpp::Waitable::SharedPtr &
   get_waitable(size_t i) {return exec_list_.waitable[i];}
 
 private:
@@ -349,6 +367,15 @@ private:
 
   /// Bool to check if the entities collector has been initialized
   bool initialized_ = false;
+
+  /// Bool to allocate the receive message of subscriptions when collecting them
+  bool preallocate_messages_ = false;
+
+  /// How refresh_wait_set() waits
+  rclcpp::ExecutorWaitPolicy wait_policy_ = rclcpp::ExecutorWaitPolicy::Block;
+
+  /// How long refresh_wait_set() polls before blocking with SpinThenBlock
+  std::chrono::nanoseconds busy_poll_duration_{0};
 };
 
 }  // namespace executors
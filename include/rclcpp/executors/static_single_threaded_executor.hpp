@@ -54,6 +54,10 @@ namespace executors
  * exec.add_node(node);
  * exec.spin();
  * exec.remove_node(node);
+ *
+ * For real-time use, set rclcpp::ExecutorOptions::preallocate_messages so that
+ * messages are taken into storage allocated when the entities are collected,
+ * and spinning over an unchanged set of entities doesn't allocate.
  */
 class StaticSingleThreadedExecutor : public rclcpp::Executor
 {
@@ -0,0 +1,523 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXPERIMENTAL__COROUTINE_HPP_
+#define RCLCPP__EXPERIMENTAL__COROUTINE_HPP_
+
+#include <exception>
+
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+namespace detail
+{
+
+/// Keep the exception which escaped a coroutine run by this thread, to rethrow it later.
+/**
+ * Only the first exception is kept until it is taken.
+ */
+RCLCPP_PUBLIC
+void
+set_coroutine_exception(std::exception_ptr exception);
+
+/// Take the exception which escaped a coroutine run by this thread, null if none.
+RCLCPP_PUBLIC
+std::exception_ptr
+take_coroutine_exception();
+
+/// Rethrow the exception which escaped a coroutine run by this thread, if any.
+/**
+ * The executors call this once a callback returned, as a callback written as a coroutine
+ * returns, instead of throwing, when an exception escapes it.
+ */
+RCLCPP_PUBLIC
+void
+rethrow_coroutine_exception();
+
+}  // namespace detail
+}  // namespace experimental
+}  // namespace rclcpp
+
+// Coroutines need C++20, the rest of this header is empty when compiled for an older standard.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "rcl/wait.h"
+
+#include "rclcpp/callback_group.hpp"
+#include "rclcpp/client.hpp"
+#include "rclcpp/context.hpp"
+#include "rclcpp/contexts/default_context.hpp"
+#include "rclcpp/create_timer.hpp"
+#include "rclcpp/detail/add_guard_condition_to_rcl_wait_set.hpp"
+#include "rclcpp/guard_condition.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/node_interfaces/get_node_base_interface.hpp"
+#include "rclcpp/node_interfaces/get_node_timers_interface.hpp"
+#include "rclcpp/node_interfaces/get_node_waitables_interface.hpp"
+#include "rclcpp/timer.hpp"
+#include "rclcpp/waitable.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+/// Return type of callbacks written as coroutines.
+/**
+ * A callback returning CoroutineTask runs like any other callback until its first co_await
+ * which suspends it, then the executor resumes it once the awaited operation completed.
+ * The coroutine is not owned by anybody and frees itself once it returns.
+ * An exception escaping the coroutine propagates out of the executor, like one escaping any
+ * other callback, once the coroutine freed itself: the executor rethrows it when the callback
+ * returns, or the scheduler when the coroutine was resumed by it.
+ *
+ * Parameters taken by reference, such as `const Goal::ConstSharedPtr &`, dangle after the
+ * first suspension, as the executor destroys what they refer to when the callback returns.
+ * Take them by value instead.
+ * The captures of a lambda live in the callback, so they are valid as long as the
+ * subscription, timer or service, which must outlive the coroutine.
+ *
+ * Example:
+ *
+ * ```cpp
+ * auto scheduler = rclcpp::experimental::create_coroutine_scheduler(node);
+ * auto sub = node->create_subscription<Goal>(
+ *   "goal", 10,
+ *   [=](Goal::ConstSharedPtr goal) -> rclcpp::experimental::CoroutineTask {
+ *     auto request = std::make_shared<Plan::Request>();
+ *     request->goal = *goal;
+ *     auto response = co_await scheduler->async_response(client, request);
+ *     co_await scheduler->sleep_for(*node, std::chrono::milliseconds(100));
+ *     publisher->publish(response->path);
+ *   });
+ * ```
+ */
+class CoroutineTask
+{
+public:
+  struct promise_type
+  {
+    CoroutineTask
+    get_return_object() noexcept {return {};}
+
+    std::suspend_never
+    initial_suspend() noexcept {return {};}
+
+    std::suspend_never
+    final_suspend() noexcept {return {};}
+
+    void
+    return_void() noexcept {}
+
+    void
+    unhandled_exception() noexcept
+    {
+      // Rethrowing would leave the coroutine suspended at its final point and never freed,
+      // so the exception is rethrown by the executor once the coroutine freed itself.
+      detail::set_coroutine_exception(std::current_exception());
+    }
+  };
+};
+
+/// Waitable resuming suspended coroutines from the executor.
+/**
+ * Operations awaited by a coroutine complete in whatever thread finishes them, then hand the
+ * coroutine to the scheduler, which resumes it when it is executed.
+ * So coroutines are always resumed by the executor spinning the scheduler and honor the
+ * callback group the scheduler was added to.
+ */
+class CoroutineScheduler : public rclcpp::Waitable
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(CoroutineScheduler)
+
+  explicit CoroutineScheduler(
+    rclcpp::Context::SharedPtr context = rclcpp::contexts::get_global_default_context())
+  : gc_(context)
+  {}
+
+  /// Resume the coroutine the next time the scheduler is executed.
+  /**
+   * This may be called from any thread.
+   */
+  void
+  schedule(std::coroutine_handle<> handle)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.push_back(handle);
+    }
+    gc_.trigger();
+  }
+
+  size_t
+  get_number_of_ready_guard_conditions() override {return 1;}
+
+  void
+  add_to_wait_set(rcl_wait_set_t * wait_set) override
+  {
+    rclcpp::detail::add_guard_condition_to_rcl_wait_set(*wait_set, gc_);
+  }
+
+  bool
+  is_ready(rcl_wait_set_t * wait_set) override
+  {
+    (void) wait_set;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !pending_.empty();
+  }
+
+  std::shared_ptr<void>
+  take_data() override
+  {
+    // The coroutines to resume are taken in execute(), so nothing is allocated per execution.
+    return nullptr;
+  }
+
+  /// Resume the coroutines that were scheduled before this call.
+  /**
+   * Coroutines scheduled while resuming are left for the next execution, and the guard
+   * condition is triggered again so that the executor wakes up for them.
+   * \throws the exception escaping a resumed coroutine, once it is freed, leaving the
+   *   coroutines after it for the next execution.
+   */
+  void
+  execute(std::shared_ptr<void> & data) override
+  {
+    (void) data;
+    size_t count;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      count = pending_.size();
+    }
+    std::exception_ptr exception;
+    for (; count > 0 && !exception; --count) {
+      std::coroutine_handle<> handle;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.empty()) {
+          break;
+        }
+        handle = pending_.front();
+        pending_.pop_front();
+      }
+      exception = resume(handle);
+    }
+    bool has_pending;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      has_pending = !pending_.empty();
+    }
+    if (has_pending) {
+      gc_.trigger();
+    }
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+
+  /// Awaitable resuming the coroutine through a scheduler once an operation completed.
+  /**
+   * The operation is started in await_suspend() and may complete in another thread before
+   * await_suspend() returns, so the coroutine is scheduled by whichever of the two finishes
+   * last, which keeps the awaiter alive until neither touches it anymore.
+   */
+  class ResumingAwaiter
+  {
+public:
+    explicit ResumingAwaiter(CoroutineScheduler & scheduler)
+    : scheduler_(scheduler)
+    {}
+
+    bool
+    await_ready() const noexcept {return false;}
+
+protected:
+    /// Called once the coroutine is suspended and the operation is started.
+    void
+    started(std::coroutine_handle<> handle)
+    {
+      handle_ = handle;
+      arrive();
+    }
+
+    /// Called once the operation completed.
+    void
+    completed()
+    {
+      arrive();
+    }
+
+private:
+    void
+    arrive()
+    {
+      if (arrived_.exchange(true, std::memory_order_acq_rel)) {
+        scheduler_.schedule(handle_);
+      }
+    }
+
+    CoroutineScheduler & scheduler_;
+    std::coroutine_handle<> handle_;
+    std::atomic<bool> arrived_{false};
+  };
+
+  /// Awaitable sending a request and returning the response of the service.
+  template<typename ServiceT>
+  class ResponseAwaiter : public ResumingAwaiter
+  {
+public:
+    using SharedRequest = typename rclcpp::Client<ServiceT>::SharedRequest;
+    using SharedResponse = typename rclcpp::Client<ServiceT>::SharedResponse;
+    using SharedFuture = typename rclcpp::Client<ServiceT>::SharedFuture;
+
+    ResponseAwaiter(
+      CoroutineScheduler & scheduler,
+      typename rclcpp::Client<ServiceT>::SharedPtr client,
+      SharedRequest request)
+    : ResumingAwaiter(scheduler), client_(std::move(client)), request_(std::move(request))
+    {}
+
+    void
+    await_suspend(std::coroutine_handle<> handle)
+    {
+      client_->async_send_request(
+        request_,
+        [this](SharedFuture future) {
+          response_ = future.get();
+          this->completed();
+        });
+      this->started(handle);
+    }
+
+    SharedResponse
+    await_resume() {return std::move(response_);}
+
+private:
+    typename rclcpp::Client<ServiceT>::SharedPtr client_;
+    SharedRequest request_;
+    SharedResponse response_;
+  };
+
+  /// Awaitable waiting for a duration with a one-shot wall timer.
+  class SleepAwaiter : public ResumingAwaiter
+  {
+public:
+    SleepAwaiter(
+      CoroutineScheduler & scheduler,
+      rclcpp::node_interfaces::NodeBaseInterface * node_base,
+      rclcpp::node_interfaces::NodeTimersInterface * node_timers,
+      std::chrono::nanoseconds duration)
+    : ResumingAwaiter(scheduler),
+      node_base_(node_base), node_timers_(node_timers), duration_(duration)
+    {}
+
+    void
+    await_suspend(std::coroutine_handle<> handle)
+    {
+      timer_ = rclcpp::create_wall_timer(
+        duration_,
+        [this](rclcpp::TimerBase & timer) {
+          timer.cancel();
+          this->completed();
+        },
+        nullptr, node_base_, node_timers_);
+      this->started(handle);
+    }
+
+    void
+    await_resume() noexcept {}
+
+private:
+    rclcpp::node_interfaces::NodeBaseInterface * node_base_;
+    rclcpp::node_interfaces::NodeTimersInterface * node_timers_;
+    std::chrono::nanoseconds duration_;
+    rclcpp::TimerBase::SharedPtr timer_;
+  };
+
+  /// Send a request with the client and await its response.
+  template<typename ServiceT>
+  ResponseAwaiter<ServiceT>
+  async_response(
+    std::shared_ptr<rclcpp::Client<ServiceT>> client,
+    typename rclcpp::Client<ServiceT>::SharedRequest request)
+  {
+    return ResponseAwaiter<ServiceT>(*this, std::move(client), std::move(request));
+  }
+
+  /// Await the given duration of wall time, using a timer of the given node.
+  template<typename NodeT, typename DurationRepT, typename DurationT>
+  SleepAwaiter
+  sleep_for(NodeT && node, std::chrono::duration<DurationRepT, DurationT> duration)
+  {
+    return SleepAwaiter(
+      *this,
+      rclcpp::node_interfaces::get_node_base_interface(node).get(),
+      rclcpp::node_interfaces::get_node_timers_interface(node).get(),
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration));
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(CoroutineScheduler)
+
+  /// Resume the coroutine and return the exception which escaped it, if any.
+  static
+  std::exception_ptr
+  resume(std::coroutine_handle<> handle)
+  {
+    handle.resume();
+    return detail::take_coroutine_exception();
+  }
+
+  rclcpp::GuardCondition gc_;
+  std::mutex mutex_;
+  std::deque<std::coroutine_handle<>> pending_;
+};
+
+/// Queue of values that coroutines can await, such as the messages of a topic.
+/**
+ * Values are pushed from any thread, typically from a subscription callback, and each one is
+ * handed to a single awaiting coroutine, or kept until a coroutine awaits the next value.
+ *
+ * ```cpp
+ * rclcpp::experimental::CoroutineChannel<Pose::ConstSharedPtr> poses(scheduler);
+ * auto sub = node->create_subscription<Pose>(
+ *   "pose", 10, [&poses](Pose::ConstSharedPtr pose) {poses.push(std::move(pose));});
+ * // In a coroutine:
+ * Pose::ConstSharedPtr pose = co_await poses.next();
+ * ```
+ */
+template<typename ValueT>
+class CoroutineChannel
+{
+public:
+  class NextAwaiter
+  {
+public:
+    explicit NextAwaiter(CoroutineChannel & channel)
+    : channel_(channel)
+    {}
+
+    bool
+    await_ready()
+    {
+      std::lock_guard<std::mutex> lock(channel_.mutex_);
+      return channel_.pop_value(value_);
+    }
+
+    bool
+    await_suspend(std::coroutine_handle<> handle)
+    {
+      std::lock_guard<std::mutex> lock(channel_.mutex_);
+      // A value may have been pushed since await_ready().
+      if (channel_.pop_value(value_)) {
+        return false;
+      }
+      handle_ = handle;
+      channel_.waiters_.push_back(this);
+      return true;
+    }
+
+    ValueT
+    await_resume() {return std::move(*value_);}
+
+private:
+    friend class CoroutineChannel;
+
+    CoroutineChannel & channel_;
+    std::coroutine_handle<> handle_;
+    std::optional<ValueT> value_;
+  };
+
+  explicit CoroutineChannel(CoroutineScheduler::SharedPtr scheduler)
+  : scheduler_(std::move(scheduler))
+  {}
+
+  /// Hand the value to the first awaiting coroutine, or keep it for the next one.
+  void
+  push(ValueT value)
+  {
+    std::coroutine_handle<> handle;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (waiters_.empty()) {
+        values_.push_back(std::move(value));
+        return;
+      }
+      NextAwaiter * waiter = waiters_.front();
+      waiters_.pop_front();
+      waiter->value_.emplace(std::move(value));
+      handle = waiter->handle_;
+    }
+    scheduler_->schedule(handle);
+  }
+
+  /// Await the next value.
+  NextAwaiter
+  next() {return NextAwaiter(*this);}
+
+private:
+  RCLCPP_DISABLE_COPY(CoroutineChannel)
+
+  bool
+  pop_value(std::optional<ValueT> & value)
+  {
+    if (values_.empty()) {
+      return false;
+    }
+    value.emplace(std::move(values_.front()));
+    values_.pop_front();
+    return true;
+  }
+
+  CoroutineScheduler::SharedPtr scheduler_;
+  std::mutex mutex_;
+  std::deque<ValueT> values_;
+  std::deque<NextAwaiter *> waiters_;
+};
+
+/// Create a coroutine scheduler and add it to the node.
+/**
+ * \param[in] node the node spinning the scheduler.
+ * \param[in] group the callback group coroutines are resumed in, the default one if null.
+ * \return the scheduler, to await operations in coroutines.
+ */
+template<typename NodeT>
+CoroutineScheduler::SharedPtr
+create_coroutine_scheduler(NodeT && node, rclcpp::CallbackGroup::SharedPtr group = nullptr)
+{
+  auto node_base = rclcpp::node_interfaces::get_node_base_interface(node);
+  auto scheduler = std::make_shared<CoroutineScheduler>(node_base->get_context());
+  rclcpp::node_interfaces::get_node_waitables_interface(node)->add_waitable(scheduler, group);
+  return scheduler;
+}
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#endif  // RCLCPP__EXPERIMENTAL__COROUTINE_HPP_
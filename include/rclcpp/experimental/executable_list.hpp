@@ -30,6 +30,10 @@ namespace experimental
 {
 
 /// This class contains subscriptionbase, timerbase, etc. which can be used to run callbacks.
+/**
+ * clear() keeps the capacity of the vectors, so refilling the list with the
+ * same entities doesn't allocate.
+ */
 class ExecutableList final
 {
 public:
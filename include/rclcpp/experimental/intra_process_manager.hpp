@@ -36,8 +36,11 @@
 #include "rclcpp/logging.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/publisher_base.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialized_message.hpp"
 #include "rclcpp/type_adapter.hpp"
 #include "rclcpp/visibility_control.hpp"
+#include "rosidl_runtime_cpp/traits.hpp"
 
 #ifdef INTERNEURON
 #include "rclcpp/message_info.hpp"
@@ -90,6 +93,19 @@ namespace experimental
  * This information allows this class to operate efficiently by performing the
  * fewest number of copies of the message required.
  *
+ * Subscriptions receiving serialized messages, like the ones of a GenericSubscription,
+ * are kept apart from the typed ones.
+ * A typed message is serialized at most once per publish, and only if such a
+ * subscription is matched with the publisher; the result is shared by all of them.
+ * Serialized messages published intra-process are shared with the serialized
+ * subscriptions and deserialized by each typed subscription.
+ *
+ * Typed subscriptions can have a content filter, which this class evaluates on the
+ * ROS message before storing it in their buffer, as the middleware would do.
+ * Messages published with a custom type by a TypeAdapter publisher are only filtered
+ * when they have to be converted to a ROS message anyway, and serialized
+ * subscriptions are never filtered.
+ *
  * This class is neither CopyConstructable nor CopyAssignable.
  */
 class IntraProcessManager
@@ -177,6 +193,10 @@ public:
    * \param intra_process_publisher_id the id of the publisher of this message.
    * \param message the message that is being stored.
    * \param allocator for allocations when buffering messages.
+   * \param ros_message for a TypeAdapter message, the ROS message it was already
+   *   converted to, if any, used instead of converting it again for the subscriptions
+   *   expecting the ROS message type; if not set, it is set to the converted ROS message
+   *   shared with them, if any. Can be nullptr.
    */
   template<
     typename MessageT,
@@ -188,7 +208,8 @@ public:
   do_intra_process_publish(
     uint64_t intra_process_publisher_id,
     std::unique_ptr<MessageT, Deleter> message,
-    typename allocator::AllocRebind<MessageT, Alloc>::allocator_type & allocator)
+    typename allocator::AllocRebind<MessageT, Alloc>::allocator_type & allocator,
+    std::shared_ptr<const ROSMessageType> * ros_message = nullptr)
   {
     using MessageAllocTraits = allocator::AllocRebind<MessageT, Alloc>;
     using MessageAllocatorT = typename MessageAllocTraits::allocator_type;
@@ -205,12 +226,18 @@ public:
     }
     const auto & sub_ids = publisher_it->second;
 
+    if (!sub_ids.serialized_subscriptions.empty()) {
+      // Serialize before the message is moved to the typed subscriptions.
+      this->template add_serialized_msg_to_buffers<MessageT, ROSMessageType>(
+        *message, sub_ids.serialized_subscriptions, ros_message);
+    }
+
     if (sub_ids.take_ownership_subscriptions.empty()) {
       // None of the buffers require ownership, so we promote the pointer
       std::shared_ptr<MessageT> msg = std::move(message);
 
       this->template add_shared_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
-        msg, sub_ids.take_shared_subscriptions);
+        msg, sub_ids.take_shared_subscriptions, ros_message);
     } else if (!sub_ids.take_ownership_subscriptions.empty() && // NOLINT
       sub_ids.take_shared_subscriptions.size() <= 1)
     {
@@ -226,7 +253,7 @@ public:
       this->template add_owned_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
         std::move(message),
         concatenated_vector,
-        allocator);
+        allocator, ros_message);
     } else if (!sub_ids.take_ownership_subscriptions.empty() && // NOLINT
       sub_ids.take_shared_subscriptions.size() > 1)
     {
@@ -235,9 +262,9 @@ public:
       auto shared_msg = std::allocate_shared<MessageT, MessageAllocatorT>(allocator, *message);
 
       this->template add_shared_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
-        shared_msg, sub_ids.take_shared_subscriptions);
+        shared_msg, sub_ids.take_shared_subscriptions, ros_message);
       this->template add_owned_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
-        std::move(message), sub_ids.take_ownership_subscriptions, allocator);
+        std::move(message), sub_ids.take_ownership_subscriptions, allocator, ros_message);
     }
   }
 
@@ -251,7 +278,8 @@ public:
   do_intra_process_publish_and_return_shared(
     uint64_t intra_process_publisher_id,
     std::unique_ptr<MessageT, Deleter> message,
-    typename allocator::AllocRebind<MessageT, Alloc>::allocator_type & allocator)
+    typename allocator::AllocRebind<MessageT, Alloc>::allocator_type & allocator,
+    std::shared_ptr<const ROSMessageType> * ros_message = nullptr)
   {
     using MessageAllocTraits = allocator::AllocRebind<MessageT, Alloc>;
     using MessageAllocatorT = typename MessageAllocTraits::allocator_type;
@@ -268,12 +296,18 @@ public:
     }
     const auto & sub_ids = publisher_it->second;
 
+    if (!sub_ids.serialized_subscriptions.empty()) {
+      // Serialize before the message is moved to the typed subscriptions.
+      this->template add_serialized_msg_to_buffers<MessageT, ROSMessageType>(
+        *message, sub_ids.serialized_subscriptions, ros_message);
+    }
+
     if (sub_ids.take_ownership_subscriptions.empty()) {
       // If there are no owning, just convert to shared.
       std::shared_ptr<MessageT> shared_msg = std::move(message);
       if (!sub_ids.take_shared_subscriptions.empty()) {
         this->template add_shared_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
-          shared_msg, sub_ids.take_shared_subscriptions);
+          shared_msg, sub_ids.take_shared_subscriptions, ros_message);
       }
       return shared_msg;
     } else {
@@ -284,24 +318,28 @@ public:
       if (!sub_ids.take_shared_subscriptions.empty()) {
         this->template add_shared_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
           shared_msg,
-          sub_ids.take_shared_subscriptions);
+          sub_ids.take_shared_subscriptions, ros_message);
       }
       if (!sub_ids.take_ownership_subscriptions.empty()) {
         this->template add_owned_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
           std::move(message),
           sub_ids.take_ownership_subscriptions,
-          allocator);
+          allocator, ros_message);
       }
       return shared_msg;
     }
   }
 
 #ifdef INTERNEURON
-//todo, not as simple as before, need to copy the message_info
-  /// Publishes an intra-process message, passed as a unique pointer.
+  /// Publishes an intra-process message, passed as a unique pointer, with its message info.
   /**
    * This is one of the two methods for publishing intra-process.
    *
+   * MessageT can be either the ROS message type or the custom_type of a
+   * TypeAdapter, in which case the message is only converted for the
+   * subscriptions expecting the ROS message type.
+   * Every subscription gets its own copy of the message info.
+   *
    * Using the intra-process publisher id, a list of recipients is obtained.
    * This list is split in half, depending whether they require ownership or not.
    *
@@ -321,6 +359,10 @@ public:
    * \param intra_process_publisher_id the id of the publisher of this message.
    * \param message the message that is being stored.
    * \param allocator for allocations when buffering messages.
+   * \param ros_message for a TypeAdapter message, the ROS message it was already
+   *   converted to, if any, used instead of converting it again for the subscriptions
+   *   expecting the ROS message type; if not set, it is set to the converted ROS message
+   *   shared with them, if any. Can be nullptr.
    */
   template<
     typename MessageT,
@@ -333,7 +375,8 @@ public:
     uint64_t intra_process_publisher_id,
     std::unique_ptr<MessageT, Deleter> message,
     typename allocator::AllocRebind<MessageT, Alloc>::allocator_type & allocator,
-    std::unique_ptr<rclcpp::MessageInfo> message_info)
+    std::unique_ptr<rclcpp::MessageInfo> message_info,
+    std::shared_ptr<const ROSMessageType> * ros_message = nullptr)
   {
     using MessageAllocTraits = allocator::AllocRebind<MessageT, Alloc>;
     using MessageAllocatorT = typename MessageAllocTraits::allocator_type;
@@ -350,13 +393,19 @@ public:
     }
     const auto & sub_ids = publisher_it->second;
 
+    if (!sub_ids.serialized_subscriptions.empty()) {
+      // Serialize before the message is moved to the typed subscriptions.
+      this->template add_serialized_msg_to_buffers<MessageT, ROSMessageType>(
+        *message, sub_ids.serialized_subscriptions, ros_message);
+    }
+
     //todo, maybe I should add info to the message_info to split different sub
     if (sub_ids.take_ownership_subscriptions.empty()) {
       // None of the buffers require ownership, so we promote the pointer
       std::shared_ptr<MessageT> msg = std::move(message);
 
       this->template add_shared_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
-        msg, sub_ids.take_shared_subscriptions, std::move(message_info));
+        msg, sub_ids.take_shared_subscriptions, std::move(message_info), ros_message);
     } else if (!sub_ids.take_ownership_subscriptions.empty() && // NOLINT
       sub_ids.take_shared_subscriptions.size() <= 1)
     {
@@ -372,7 +421,7 @@ public:
       this->template add_owned_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
         std::move(message),
         concatenated_vector,
-        allocator,std::move(message_info));
+        allocator,std::move(message_info), ros_message);
     } else if (!sub_ids.take_ownership_subscriptions.empty() && // NOLINT
       sub_ids.take_shared_subscriptions.size() > 1)
     {
@@ -381,9 +430,9 @@ public:
       auto shared_msg = std::allocate_shared<MessageT, MessageAllocatorT>(allocator, *message);
 
       this->template add_shared_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
-        shared_msg, sub_ids.take_shared_subscriptions, std::make_unique<rclcpp::MessageInfo>(*message_info));
+        shared_msg, sub_ids.take_shared_subscriptions, std::make_unique<rclcpp::MessageInfo>(*message_info), ros_message);
       this->template add_owned_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
-        std::move(message), sub_ids.take_ownership_subscriptions, allocator,std::move(message_info));
+        std::move(message), sub_ids.take_ownership_subscriptions, allocator,std::move(message_info), ros_message);
     }
   }
 
@@ -398,7 +447,8 @@ public:
     uint64_t intra_process_publisher_id,
     std::unique_ptr<MessageT, Deleter> message,
     typename allocator::AllocRebind<MessageT, Alloc>::allocator_type & allocator,
-    std::unique_ptr<rclcpp::MessageInfo> message_info)
+    std::unique_ptr<rclcpp::MessageInfo> message_info,
+    std::shared_ptr<const ROSMessageType> * ros_message = nullptr)
   {
     using MessageAllocTraits = allocator::AllocRebind<MessageT, Alloc>;
     using MessageAllocatorT = typename MessageAllocTraits::allocator_type;
@@ -415,12 +465,18 @@ public:
     }
     const auto & sub_ids = publisher_it->second;
 
+    if (!sub_ids.serialized_subscriptions.empty()) {
+      // Serialize before the message is moved to the typed subscriptions.
+      this->template add_serialized_msg_to_buffers<MessageT, ROSMessageType>(
+        *message, sub_ids.serialized_subscriptions, ros_message);
+    }
+
     if (sub_ids.take_ownership_subscriptions.empty()) {
       // If there are no owning, just convert to shared.
       std::shared_ptr<MessageT> shared_msg = std::move(message);
       if (!sub_ids.take_shared_subscriptions.empty()) {
         this->template add_shared_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
-          shared_msg, sub_ids.take_shared_subscriptions, std::move(message_info));
+          shared_msg, sub_ids.take_shared_subscriptions, std::move(message_info), ros_message);
       }
       return shared_msg;
     } else {
@@ -431,19 +487,38 @@ public:
       if (!sub_ids.take_shared_subscriptions.empty()) {
         this->template add_shared_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
           shared_msg,
-          sub_ids.take_shared_subscriptions, std::make_unique<rclcpp::MessageInfo>(*message_info));
+          sub_ids.take_shared_subscriptions, std::make_unique<rclcpp::MessageInfo>(*message_info), ros_message);
       }
       if (!sub_ids.take_ownership_subscriptions.empty()) {
         this->template add_owned_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
           std::move(message),
           sub_ids.take_ownership_subscriptions,
-          allocator,std::move(message_info));
+          allocator,std::move(message_info), ros_message);
       }//this should always be true, right?
       return shared_msg;
     }
   }
 #endif
 
+  /// Publishes an intra-process serialized message.
+  /**
+   * The message is shared with the subscriptions receiving serialized messages,
+   * and deserialized by every typed subscription matched with the publisher.
+   *
+   * This method can throw an exception if a typed subscription fails to
+   * deserialize the message.
+   *
+   * This method does allocate memory.
+   *
+   * \param intra_process_publisher_id the id of the publisher of this message.
+   * \param message the serialized message that is being stored.
+   */
+  RCLCPP_PUBLIC
+  void
+  do_serialized_intra_process_publish(
+    uint64_t intra_process_publisher_id,
+    std::shared_ptr<const rclcpp::SerializedMessage> message);
+
   /// Return true if the given rmw_gid_t matches any stored Publishers.
   RCLCPP_PUBLIC
   bool
@@ -463,6 +538,7 @@ private:
   {
     std::vector<uint64_t> take_shared_subscriptions;
     std::vector<uint64_t> take_ownership_subscriptions;
+    std::vector<uint64_t> serialized_subscriptions;
   };
 
   using SubscriptionMap =
@@ -481,7 +557,11 @@ private:
 
   RCLCPP_PUBLIC
   void
-  insert_sub_id_for_pub(uint64_t sub_id, uint64_t pub_id, bool use_take_shared_method);
+  insert_sub_id_for_pub(
+    uint64_t sub_id,
+    uint64_t pub_id,
+    bool use_take_shared_method,
+    bool is_serialized);
 
   RCLCPP_PUBLIC
   bool
@@ -489,6 +569,77 @@ private:
     rclcpp::PublisherBase::SharedPtr pub,
     rclcpp::experimental::SubscriptionIntraProcessBase::SharedPtr sub) const;
 
+  /// Remove the subscriptions whose content filter the ROS message doesn't match.
+  RCLCPP_PUBLIC
+  void
+  remove_filtered_out_subscriptions(
+    const void * ros_message,
+    std::vector<uint64_t> & subscription_ids) const;
+
+  /// Give a serialized message to the given subscriptions, sharing it.
+  RCLCPP_PUBLIC
+  void
+  add_shared_serialized_msg_to_buffers(
+    std::shared_ptr<const rclcpp::SerializedMessage> message,
+    const std::vector<uint64_t> & subscription_ids);
+
+  /// Serialize a typed message once and give it to the serialized subscriptions.
+  template<
+    typename MessageT,
+    typename ROSMessageType>
+  void
+  add_serialized_msg_to_buffers(
+    const MessageT & message,
+    const std::vector<uint64_t> & subscription_ids,
+    std::shared_ptr<const ROSMessageType> * ros_message = nullptr)
+  {
+    if constexpr (rosidl_generator_traits::is_message<ROSMessageType>::value) {
+      auto serialized_msg = std::make_shared<rclcpp::SerializedMessage>();
+      rclcpp::Serialization<ROSMessageType> serializer;
+      if constexpr (rclcpp::TypeAdapter<MessageT>::is_specialized::value) {
+        auto ros_msg =
+          this->template get_converted_ros_message<MessageT, ROSMessageType>(message, ros_message);
+        serializer.serialize_message(ros_msg.get(), serialized_msg.get());
+      } else if constexpr (std::is_same<MessageT, ROSMessageType>::value) {
+        serializer.serialize_message(&message, serialized_msg.get());
+      } else {
+        ROSMessageType ros_msg;
+        rclcpp::TypeAdapter<MessageT, ROSMessageType>::convert_to_ros_message(message, ros_msg);
+        serializer.serialize_message(&ros_msg, serialized_msg.get());
+      }
+      add_shared_serialized_msg_to_buffers(std::move(serialized_msg), subscription_ids);
+    } else {
+      (void)message;
+      (void)subscription_ids;
+      (void)ros_message;
+    }
+  }
+
+  /// Return the ROS message of a TypeAdapter message, converting it at most once per publish.
+  /**
+   * \param message the message to convert.
+   * \param ros_message the ROS message already converted for this publish, if any,
+   *   which is set to the converted one otherwise; can be nullptr.
+   */
+  template<
+    typename MessageT,
+    typename ROSMessageType>
+  std::shared_ptr<const ROSMessageType>
+  get_converted_ros_message(
+    const MessageT & message,
+    std::shared_ptr<const ROSMessageType> * ros_message)
+  {
+    if (ros_message && *ros_message) {
+      return *ros_message;
+    }
+    auto converted_ros_message = std::make_shared<ROSMessageType>();
+    rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(message, *converted_ros_message);
+    if (ros_message) {
+      *ros_message = converted_ros_message;
+    }
+    return converted_ros_message;
+  }
+
   template<
     typename MessageT,
     typename Alloc,
@@ -497,7 +648,8 @@ private:
   void
   add_shared_msg_to_buffers(
     std::shared_ptr<const MessageT> message,
-    std::vector<uint64_t> subscription_ids)
+    std::vector<uint64_t> subscription_ids,
+    std::shared_ptr<const ROSMessageType> * ros_message = nullptr)
   {
     using ROSMessageTypeAllocatorTraits = allocator::AllocRebind<ROSMessageType, Alloc>;
     using ROSMessageTypeAllocator = typename ROSMessageTypeAllocatorTraits::allocator_type;
@@ -508,6 +660,12 @@ private:
     using PublishedTypeAllocator = typename PublishedTypeAllocatorTraits::allocator_type;
     using PublishedTypeDeleter = allocator::Deleter<PublishedTypeAllocator, PublishedType>;
 
+    // Convert at most once for all the subscriptions expecting the ROS message type.
+    std::shared_ptr<const ROSMessageType> converted_ros_message;
+    if (!ros_message) {
+      ros_message = &converted_ros_message;
+    }
+
     for (auto id : subscription_ids) {
       auto subscription_it = subscriptions_.find(id);
       if (subscription_it == subscriptions_.end()) {
@@ -518,6 +676,11 @@ private:
         subscriptions_.erase(id);
         continue;
       }
+      if constexpr (std::is_same<MessageT, ROSMessageType>::value) {
+        if (!subscription_base->matches_content_filter(message.get())) {
+          continue;
+        }
+      }
 
       auto subscription = std::dynamic_pointer_cast<
         rclcpp::experimental::SubscriptionIntraProcessBuffer<PublishedType,
@@ -542,10 +705,13 @@ private:
       }
 
       if constexpr (rclcpp::TypeAdapter<MessageT>::is_specialized::value) {
-        ROSMessageType ros_msg;
-        rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*message, ros_msg);
+        auto ros_msg =
+          this->template get_converted_ros_message<MessageT, ROSMessageType>(*message, ros_message);
+        if (!subscription_base->matches_content_filter(ros_msg.get())) {
+          continue;
+        }
         ros_message_subscription->provide_intra_process_message(
-          std::make_shared<ROSMessageType>(ros_msg));
+          ros_msg);
       } else {
         if constexpr (std::is_same<MessageT, ROSMessageType>::value) {
           ros_message_subscription->provide_intra_process_message(message);
@@ -556,6 +722,9 @@ private:
             ROSMessageType ros_msg;
             rclcpp::TypeAdapter<MessageT, ROSMessageType>::convert_to_ros_message(
               *message, ros_msg);
+            if (!subscription_base->matches_content_filter(&ros_msg)) {
+              continue;
+            }
             ros_message_subscription->provide_intra_process_message(
               std::make_shared<ROSMessageType>(ros_msg));
           }
@@ -573,7 +742,8 @@ private:
   add_owned_msg_to_buffers(
     std::unique_ptr<MessageT, Deleter> message,
     std::vector<uint64_t> subscription_ids,
-    typename allocator::AllocRebind<MessageT, Alloc>::allocator_type & allocator)
+    typename allocator::AllocRebind<MessageT, Alloc>::allocator_type & allocator,
+    std::shared_ptr<const ROSMessageType> * ros_message = nullptr)
   {
     using MessageAllocTraits = allocator::AllocRebind<MessageT, Alloc>;
     using MessageUniquePtr = std::unique_ptr<MessageT, Deleter>;
@@ -587,6 +757,11 @@ private:
     using PublishedTypeAllocator = typename PublishedTypeAllocatorTraits::allocator_type;
     using PublishedTypeDeleter = allocator::Deleter<PublishedTypeAllocator, PublishedType>;
 
+    if constexpr (std::is_same<MessageT, ROSMessageType>::value) {
+      // Skip the filtered out subscriptions first, so the last remaining one gets ownership.
+      remove_filtered_out_subscriptions(message.get(), subscription_ids);
+    }
+
     for (auto it = subscription_ids.begin(); it != subscription_ids.end(); it++) {
       auto subscription_it = subscriptions_.find(*it);
       if (subscription_it == subscriptions_.end()) {
@@ -634,11 +809,19 @@ private:
       if constexpr (rclcpp::TypeAdapter<MessageT>::is_specialized::value) {
         ROSMessageTypeAllocator ros_message_alloc(allocator);
         auto ptr = ros_message_alloc.allocate(1);
-        ros_message_alloc.construct(ptr);
+        if (ros_message && *ros_message) {
+          // Copy the ROS message already converted by this publish.
+          ros_message_alloc.construct(ptr, **ros_message);
+        } else {
+          ros_message_alloc.construct(ptr);
+          rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*message, *ptr);
+        }
         ROSMessageTypeDeleter deleter;
         allocator::set_allocator_for_deleter(&deleter, &allocator);
-        rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*message, *ptr);
         auto ros_msg = std::unique_ptr<ROSMessageType, ROSMessageTypeDeleter>(ptr, deleter);
+        if (!subscription_base->matches_content_filter(ros_msg.get())) {
+          continue;
+        }
         ros_message_subscription->provide_intra_process_message(std::move(ros_msg));
       } else {
         if constexpr (std::is_same<MessageT, ROSMessageType>::value) {
@@ -669,7 +852,8 @@ private:
   add_shared_msg_to_buffers(
     std::shared_ptr<const MessageT> message,
     std::vector<uint64_t> subscription_ids,
-    std::unique_ptr<rclcpp::MessageInfo> message_info)
+    std::unique_ptr<rclcpp::MessageInfo> message_info,
+    std::shared_ptr<const ROSMessageType> * ros_message = nullptr)
   {
     using ROSMessageTypeAllocatorTraits = allocator::AllocRebind<ROSMessageType, Alloc>;
     using ROSMessageTypeAllocator = typename ROSMessageTypeAllocatorTraits::allocator_type;
@@ -680,6 +864,12 @@ private:
     using PublishedTypeAllocator = typename PublishedTypeAllocatorTraits::allocator_type;
     using PublishedTypeDeleter = allocator::Deleter<PublishedTypeAllocator, PublishedType>;
 
+    // Convert at most once for all the subscriptions expecting the ROS message type.
+    std::shared_ptr<const ROSMessageType> converted_ros_message;
+    if (!ros_message) {
+      ros_message = &converted_ros_message;
+    }
+
     for (auto id : subscription_ids) {
       auto subscription_it = subscriptions_.find(id);
       if (subscription_it == subscriptions_.end()) {
@@ -690,6 +880,11 @@ private:
         subscriptions_.erase(id);
         continue;
       }
+      if constexpr (std::is_same<MessageT, ROSMessageType>::value) {
+        if (!subscription_base->matches_content_filter(message.get())) {
+          continue;
+        }
+      }
 
       auto subscription = std::dynamic_pointer_cast<
         rclcpp::experimental::SubscriptionIntraProcessBuffer<PublishedType,
@@ -714,10 +909,13 @@ private:
       }
 
       if constexpr (rclcpp::TypeAdapter<MessageT>::is_specialized::value) {
-        ROSMessageType ros_msg;
-        rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*message, ros_msg);
+        auto ros_msg =
+          this->template get_converted_ros_message<MessageT, ROSMessageType>(*message, ros_message);
+        if (!subscription_base->matches_content_filter(ros_msg.get())) {
+          continue;
+        }
         ros_message_subscription->provide_intra_process_message(
-          std::make_shared<ROSMessageType>(ros_msg),std::make_unique<rclcpp::MessageInfo>(*message_info),id);
+          ros_msg,std::make_unique<rclcpp::MessageInfo>(*message_info),id);
       } else {
         if constexpr (std::is_same<MessageT, ROSMessageType>::value) {
           ros_message_subscription->provide_intra_process_message(message,std::make_unique<rclcpp::MessageInfo>(*message_info),id);
@@ -728,6 +926,9 @@ private:
             ROSMessageType ros_msg;
             rclcpp::TypeAdapter<MessageT, ROSMessageType>::convert_to_ros_message(
               *message, ros_msg);
+            if (!subscription_base->matches_content_filter(&ros_msg)) {
+              continue;
+            }
             ros_message_subscription->provide_intra_process_message(
               std::make_shared<ROSMessageType>(ros_msg),std::make_unique<rclcpp::MessageInfo>(*message_info),id);
           }
@@ -746,7 +947,8 @@ private:
     std::unique_ptr<MessageT, Deleter> message,
     std::vector<uint64_t> subscription_ids,
     typename allocator::AllocRebind<MessageT, Alloc>::allocator_type & allocator,
-    std::unique_ptr<rclcpp::MessageInfo> message_info)
+    std::unique_ptr<rclcpp::MessageInfo> message_info,
+    std::shared_ptr<const ROSMessageType> * ros_message = nullptr)
   {
     using MessageAllocTraits = allocator::AllocRebind<MessageT, Alloc>;
     using MessageUniquePtr = std::unique_ptr<MessageT, Deleter>;
@@ -760,6 +962,11 @@ private:
     using PublishedTypeAllocator = typename PublishedTypeAllocatorTraits::allocator_type;
     using PublishedTypeDeleter = allocator::Deleter<PublishedTypeAllocator, PublishedType>;
 
+    if constexpr (std::is_same<MessageT, ROSMessageType>::value) {
+      // Skip the filtered out subscriptions first, so the last remaining one gets ownership.
+      remove_filtered_out_subscriptions(message.get(), subscription_ids);
+    }
+
     for (auto it = subscription_ids.begin(); it != subscription_ids.end(); it++) {
       auto subscription_it = subscriptions_.find(*it);
       if (subscription_it == subscriptions_.end()) {
@@ -785,7 +992,9 @@ private:
           auto ptr = MessageAllocTraits::allocate(allocator, 1);
           MessageAllocTraits::construct(allocator, ptr, *message);
 
-          subscription->provide_intra_process_data(std::move(MessageUniquePtr(ptr, deleter)),std::move(message_info),*it);
+          subscription->provide_intra_process_data(
+            std::move(MessageUniquePtr(ptr, deleter)),
+            std::make_unique<rclcpp::MessageInfo>(*message_info), *it);
         }
 
         continue;
@@ -807,11 +1016,19 @@ private:
       if constexpr (rclcpp::TypeAdapter<MessageT>::is_specialized::value) {
         ROSMessageTypeAllocator ros_message_alloc(allocator);
         auto ptr = ros_message_alloc.allocate(1);
-        ros_message_alloc.construct(ptr);
+        if (ros_message && *ros_message) {
+          // Copy the ROS message already converted by this publish.
+          ros_message_alloc.construct(ptr, **ros_message);
+        } else {
+          ros_message_alloc.construct(ptr);
+          rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*message, *ptr);
+        }
         ROSMessageTypeDeleter deleter;
         allocator::set_allocator_for_deleter(&deleter, &allocator);
-        rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*message, *ptr);
         auto ros_msg = std::unique_ptr<ROSMessageType, ROSMessageTypeDeleter>(ptr, deleter);
+        if (!subscription_base->matches_content_filter(ros_msg.get())) {
+          continue;
+        }
         ros_message_subscription->provide_intra_process_message(std::move(ros_msg),std::make_unique<rclcpp::MessageInfo>(*message_info),*it);
       } else {
         if constexpr (std::is_same<MessageT, ROSMessageType>::value) {
@@ -29,6 +29,7 @@
 #include "rclcpp/clock.hpp"
 #include "rclcpp/any_subscription_callback.hpp"
 #include "rclcpp/context.hpp"
+#include "rclcpp/detail/reuse_shared_data.hpp"
 #include "rclcpp/experimental/buffers/intra_process_buffer.hpp"
 #include "rclcpp/experimental/subscription_intra_process_buffer.hpp"
 #include "rclcpp/qos.hpp"
@@ -93,7 +94,17 @@ public:
       buffer_type),
     any_callback_(callback)
   {
- 
+    // Allocate the data handed from take_data() to execute() now, it is reused afterwards.
+#ifdef INTERNEURON
+    if (any_callback_.use_take_shared_method()) {
+      shared_data_ = std::make_shared<SharedDataT>();
+    } else {
+      unique_data_ = std::make_shared<UniqueDataT>();
+    }
+#else
+    data_ = std::make_shared<DataT>();
+#endif
+
     TRACEPOINT(
       rclcpp_subscription_callback_added,
       static_cast<const void *>(this),
@@ -122,29 +133,20 @@ public:
       if (!shared_msg) {
         return nullptr;
       }
-  return std::static_pointer_cast<void>(
-      std::make_shared<std::pair<ConstMessageSharedPtr, std::unique_ptr<rclcpp::MessageInfo>>>(
-        std::pair<ConstMessageSharedPtr, std::unique_ptr<rclcpp::MessageInfo>>(
-          shared_msg, std::move(message_info)))
-    );
+      auto data = rclcpp::detail::reuse_shared_data(shared_data_);
+      data->first = std::move(shared_msg);
+      data->second = std::move(message_info);
+      return std::static_pointer_cast<void>(data);
     } else {
       std::tie(unique_msg, message_info) = this->buffer_->consume_unique_with_message_info();
       if (!unique_msg) {
         return nullptr;
       }
-  return std::static_pointer_cast<void>(
-      std::make_shared<std::pair<MessageUniquePtr, std::unique_ptr<rclcpp::MessageInfo>>>(
-        std::pair<MessageUniquePtr,std::unique_ptr<rclcpp::MessageInfo>>(
-          std::move(unique_msg), std::move(message_info)))
-    );
+      auto data = rclcpp::detail::reuse_shared_data(unique_data_);
+      data->first = std::move(unique_msg);
+      data->second = std::move(message_info);
+      return std::static_pointer_cast<void>(data);
     }
-    /*
-    return std::static_pointer_cast<void>(
-      std::make_shared<std::tuple<ConstMessageSharedPtr, MessageUniquePtr, std::unique_ptr<rclcpp::MessageInfo>>>(
-        std::tuple<ConstMessageSharedPtr, MessageUniquePtr,std::unique_ptr<rclcpp::MessageInfo>>(
-          shared_msg, std::move(unique_msg),
-        std::move(message_info)))
-    );*/
   }
   #else
   std::shared_ptr<void>
@@ -164,11 +166,10 @@ public:
         return nullptr;
       }
     }
-    return std::static_pointer_cast<void>(
-      std::make_shared<std::pair<ConstMessageSharedPtr, MessageUniquePtr>>(
-        std::pair<ConstMessageSharedPtr, MessageUniquePtr>(
-          shared_msg, std::move(unique_msg)))
-    );
+    auto data = rclcpp::detail::reuse_shared_data(data_);
+    data->first = std::move(shared_msg);
+    data->second = std::move(unique_msg);
+    return std::static_pointer_cast<void>(data);
   }
 
   #endif
@@ -197,7 +198,7 @@ protected:
     }
     
     if (any_callback_.use_take_shared_method()) {
-    auto shared_ptr = std::static_pointer_cast<std::pair<ConstMessageSharedPtr, std::unique_ptr<rclcpp::MessageInfo>>>(data);
+    auto shared_ptr = std::static_pointer_cast<SharedDataT>(data);
     if(shared_ptr->second == nullptr){
     rmw_message_info_t rmw_msg_info;
     rmw_msg_info.publisher_gid = {0, {0}};
@@ -207,9 +208,12 @@ protected:
     //msg_info.get_rmw_message_info().received_timestamp = static_cast<int64_t>(ros_clock.now().nanoseconds());
       any_callback_.dispatch_intra_process(shared_ptr->first, *(shared_ptr->second));
     }
+    // the data may be reused by the next take, don't keep the message alive until then
+    shared_ptr->first.reset();
+    shared_ptr->second.reset();
     shared_ptr.reset();
     } else {
-auto shared_ptr = std::static_pointer_cast<std::pair<MessageUniquePtr, std::unique_ptr<rclcpp::MessageInfo>>>(data);
+auto shared_ptr = std::static_pointer_cast<UniqueDataT>(data);
     if(shared_ptr->second == nullptr){
     rmw_message_info_t rmw_msg_info;
     rmw_msg_info.publisher_gid = {0, {0}};
@@ -219,6 +223,7 @@ auto shared_ptr = std::static_pointer_cast<std::pair<MessageUniquePtr, std::uniq
     //msg_info.get_rmw_message_info().received_timestamp = static_cast<int64_t>(ros_clock.now().nanoseconds());
       any_callback_.dispatch_intra_process(std::move(shared_ptr->first), *(shared_ptr->second));
     }
+    shared_ptr->second.reset();
     shared_ptr.reset();
     }
   }
@@ -236,11 +241,11 @@ auto shared_ptr = std::static_pointer_cast<std::pair<MessageUniquePtr, std::uniq
     msg_info.publisher_gid = {0, {0}};
     msg_info.from_intra_process = true;
 
-    auto shared_ptr = std::static_pointer_cast<std::pair<ConstMessageSharedPtr, MessageUniquePtr>>(
-      data);
+    auto shared_ptr = std::static_pointer_cast<DataT>(data);
 
     if (any_callback_.use_take_shared_method()) {
-      ConstMessageSharedPtr shared_msg = shared_ptr->first;
+      // the data may be reused by the next take, don't keep the message alive until then
+      ConstMessageSharedPtr shared_msg = std::move(shared_ptr->first);
       any_callback_.dispatch_intra_process(shared_msg, msg_info);
     } else {
       MessageUniquePtr unique_msg = std::move(shared_ptr->second);
@@ -251,6 +256,20 @@ auto shared_ptr = std::static_pointer_cast<std::pair<MessageUniquePtr, std::uniq
   #endif
 
   AnySubscriptionCallback<MessageT, Alloc> any_callback_;
+
+#ifdef INTERNEURON
+  using SharedDataT = std::pair<ConstMessageSharedPtr, std::unique_ptr<rclcpp::MessageInfo>>;
+  using UniqueDataT = std::pair<MessageUniquePtr, std::unique_ptr<rclcpp::MessageInfo>>;
+
+  /// Data handed from take_data() to execute(), reused across takes.
+  std::shared_ptr<SharedDataT> shared_data_;
+  std::shared_ptr<UniqueDataT> unique_data_;
+#else
+  using DataT = std::pair<ConstMessageSharedPtr, MessageUniquePtr>;
+
+  /// Data handed from take_data() to execute(), reused across takes.
+  std::shared_ptr<DataT> data_;
+#endif
 };
 
 }  // namespace experimental
@@ -16,16 +16,20 @@
 #define RCLCPP__EXPERIMENTAL__SUBSCRIPTION_INTRA_PROCESS_BASE_HPP_
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <stdexcept>
 #include <string>
 
 #include "rcl/wait.h"
 #include "rmw/impl/cpp/demangle.hpp"
 
+#include "rclcpp/detail/content_filter.hpp"
 #include "rclcpp/guard_condition.hpp"
 #include "rclcpp/logging.hpp"
 #include "rclcpp/qos.hpp"
+#include "rclcpp/serialized_message.hpp"
 #include "rclcpp/waitable.hpp"
 
 namespace rclcpp
@@ -82,6 +86,67 @@ public:
   bool
   use_take_shared_method() const = 0;
 
+  /// Return true if this subscription buffers serialized messages.
+  /**
+   * The intra process manager delivers typed messages to these subscriptions only
+   * after serializing them, and only once per publish.
+   */
+  virtual
+  bool
+  is_serialized() const
+  {
+    return false;
+  }
+
+  /// Provide a serialized message published intra-process by a serialized publisher.
+  /**
+   * Typed subscriptions deserialize the message into their own ROS message type.
+   *
+   * \param serialized_message the serialized message, shared with other subscriptions.
+   * \throws std::runtime_error if the subscription cannot receive serialized messages.
+   */
+  virtual
+  void
+  provide_serialized_intra_process_message(
+    std::shared_ptr<const rclcpp::SerializedMessage> serialized_message)
+  {
+    (void)serialized_message;
+    throw std::runtime_error(
+            "intra process subscription can't receive serialized messages");
+  }
+
+  /// Set the content filter the messages must match to be buffered.
+  /**
+   * Messages published intra-process don't go through the middleware, which is where
+   * the content filter of the subscription is applied otherwise.
+   * The intra process manager evaluates this filter instead, before giving a message
+   * to the subscription, so filtered out messages never wake up the executor.
+   *
+   * \param content_filter the filter, or nullptr to receive all the messages.
+   */
+  RCLCPP_PUBLIC
+  void
+  set_content_filter(std::shared_ptr<const rclcpp::detail::ContentFilter> content_filter);
+
+  /// Get the content filter, nullptr if there is none.
+  RCLCPP_PUBLIC
+  std::shared_ptr<const rclcpp::detail::ContentFilter>
+  get_content_filter() const;
+
+  /// Return true if there is no content filter or if the ROS message matches it.
+  /**
+   * \param ros_message a message of the ROS message type of the subscription.
+   */
+  bool
+  matches_content_filter(const void * ros_message) const
+  {
+    if (!has_content_filter_.load(std::memory_order_acquire)) {
+      return true;
+    }
+    auto content_filter = get_content_filter();
+    return !content_filter || content_filter->evaluate(ros_message);
+  }
+
   RCLCPP_PUBLIC
   const char *
   get_topic_name() const;
@@ -194,6 +259,10 @@ protected:
 private:
   std::string topic_name_;
   QoS qos_profile_;
+
+  mutable std::mutex content_filter_mutex_;
+  std::shared_ptr<const rclcpp::detail::ContentFilter> content_filter_;
+  std::atomic<bool> has_content_filter_{false};
 };
 
 }  // namespace experimental
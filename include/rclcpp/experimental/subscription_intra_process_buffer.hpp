@@ -30,7 +30,10 @@
 #include "rclcpp/experimental/subscription_intra_process_base.hpp"
 #include "rclcpp/experimental/ros_message_intra_process_buffer.hpp"
 #include "rclcpp/qos.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialized_message.hpp"
 #include "rclcpp/type_support_decl.hpp"
+#include "rosidl_runtime_cpp/traits.hpp"
 
 #ifdef INTERNEURON
 #include "rclcpp/message_info.hpp"
@@ -87,9 +90,12 @@ public:
   : SubscriptionROSMsgIntraProcessBuffer<ROSMessageType, ROSMessageTypeAllocator,
       ROSMessageTypeDeleter>(
       context, topic_name, qos_profile),
-    subscribed_type_allocator_(*allocator)
+    subscribed_type_allocator_(*allocator),
+    ros_message_type_allocator_(*allocator)
   {
     allocator::set_allocator_for_deleter(&subscribed_type_deleter_, &subscribed_type_allocator_);
+    allocator::set_allocator_for_deleter(
+      &ros_message_type_deleter_, &ros_message_type_allocator_);
 
     // Create the intra-process buffer.
     buffer_ = rclcpp::experimental::create_intra_process_buffer<SubscribedType, Alloc,
@@ -171,6 +177,27 @@ public:
     this->invoke_on_new_message();
   }
 
+  void
+  provide_serialized_intra_process_message(
+    std::shared_ptr<const rclcpp::SerializedMessage> serialized_message) override
+  {
+    if constexpr (rosidl_generator_traits::is_message<ROSMessageType>::value) {
+      auto ptr = ROSMessageTypeAllocatorTraits::allocate(ros_message_type_allocator_, 1);
+      ROSMessageTypeAllocatorTraits::construct(ros_message_type_allocator_, ptr);
+      MessageUniquePtr message(ptr, ros_message_type_deleter_);
+      rclcpp::Serialization<ROSMessageType> serializer;
+      serializer.deserialize_message(serialized_message.get(), message.get());
+      if (!this->matches_content_filter(message.get())) {
+        return;
+      }
+      provide_intra_process_message(std::move(message));
+    } else {
+      (void)serialized_message;
+      throw std::runtime_error(
+              "intra process subscription can't deserialize into a non ROS message type");
+    }
+  }
+
   #ifdef INTERNEURON
   using MessageInfoUniquePtr = std::unique_ptr<rclcpp::MessageInfo>;
 
@@ -252,6 +279,8 @@ protected:
   BufferUniquePtr buffer_;
   SubscribedTypeAllocator subscribed_type_allocator_;
   SubscribedTypeDeleter subscribed_type_deleter_;
+  ROSMessageTypeAllocator ros_message_type_allocator_;
+  ROSMessageTypeDeleter ros_message_type_deleter_;
   #ifdef INTERNEURON
   bool for_fusion_;
   bool can_trigger_;
@@ -0,0 +1,109 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXPERIMENTAL__SUBSCRIPTION_SERIALIZED_INTRA_PROCESS_HPP_
+#define RCLCPP__EXPERIMENTAL__SUBSCRIPTION_SERIALIZED_INTRA_PROCESS_HPP_
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "rcl/wait.h"
+
+#include "rclcpp/context.hpp"
+#include "rclcpp/experimental/buffers/intra_process_buffer.hpp"
+#include "rclcpp/experimental/subscription_intra_process_base.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+/// Intra-process part of a subscription receiving serialized messages.
+/**
+ * This is used by rclcpp::GenericSubscription.
+ * Messages published intra-process by typed publishers are serialized once by the
+ * intra process manager and shared by all the serialized subscriptions, while messages
+ * published by serialized publishers are shared as they are.
+ */
+class SubscriptionSerializedIntraProcess : public SubscriptionIntraProcessBase
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(SubscriptionSerializedIntraProcess)
+
+  using CallbackT = std::function<void (std::shared_ptr<rclcpp::SerializedMessage>)>;
+  using BufferUniquePtr =
+    rclcpp::experimental::buffers::IntraProcessBuffer<rclcpp::SerializedMessage>::UniquePtr;
+
+  RCLCPP_PUBLIC
+  SubscriptionSerializedIntraProcess(
+    CallbackT callback,
+    rclcpp::Context::SharedPtr context,
+    const std::string & topic_name,
+    const rclcpp::QoS & qos_profile);
+
+  RCLCPP_PUBLIC
+  virtual ~SubscriptionSerializedIntraProcess();
+
+  RCLCPP_PUBLIC
+  bool
+  is_ready(rcl_wait_set_t * wait_set) override;
+
+  RCLCPP_PUBLIC
+  std::shared_ptr<void>
+  take_data() override;
+
+  /// Call the callback with the taken message.
+  /**
+   * The message is handed over without a copy when no other subscription shares it,
+   * otherwise the callback gets its own copy since it may modify the message.
+   */
+  RCLCPP_PUBLIC
+  void
+  execute(std::shared_ptr<void> & data) override;
+
+  bool
+  use_take_shared_method() const override
+  {
+    return true;
+  }
+
+  bool
+  is_serialized() const override
+  {
+    return true;
+  }
+
+  RCLCPP_PUBLIC
+  void
+  provide_serialized_intra_process_message(
+    std::shared_ptr<const rclcpp::SerializedMessage> serialized_message) override;
+
+protected:
+  RCLCPP_PUBLIC
+  void
+  trigger_guard_condition() override;
+
+  CallbackT callback_;
+  BufferUniquePtr buffer_;
+};
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__SUBSCRIPTION_SERIALIZED_INTRA_PROCESS_HPP_
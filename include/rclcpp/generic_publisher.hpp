@@ -17,15 +17,20 @@
 #define RCLCPP__GENERIC_PUBLISHER_HPP_
 
 #include <memory>
+#include <stdexcept>
 #include <string>
 
 #include "rcpputils/shared_library.hpp"
 
 #include "rclcpp/callback_group.hpp"
+#include "rclcpp/detail/resolve_use_intra_process.hpp"
+#include "rclcpp/detail/serialized_message_pool.hpp"
+#include "rclcpp/experimental/intra_process_manager.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
 #include "rclcpp/node_interfaces/node_topics_interface.hpp"
 #include "rclcpp/publisher_base.hpp"
+#include "rclcpp/publisher_options.hpp"
 #include "rclcpp/qos.hpp"
 #include "rclcpp/serialized_message.hpp"
 #include "rclcpp/typesupport_helpers.hpp"
@@ -41,7 +46,8 @@ namespace rclcpp
  * Since the type is not known at compile time, this is not a template, and the dynamic library
  * containing type support information has to be identified and loaded based on the type name.
  *
- * It does not support intra-process handling.
+ * When intra-process communication is enabled, published messages are shared with the
+ * intra-process subscriptions receiving serialized messages and deserialized by the typed ones.
  */
 class GenericPublisher : public rclcpp::PublisherBase
 {
@@ -64,7 +70,8 @@ public:
    * \param qos %QoS settings
    * \param options %Publisher options.
    * Not all publisher options are currently respected, the only relevant options for this
-   * publisher are `event_callbacks`, `use_default_callbacks`, and `%callback_group`.
+   * publisher are `event_callbacks`, `use_default_callbacks`, `use_intra_process_comm`,
+   * and `%callback_group`.
    */
   template<typename AllocatorT = std::allocator<void>>
   GenericPublisher(
@@ -79,7 +86,8 @@ public:
       topic_name,
       *rclcpp::get_typesupport_handle(topic_type, "rosidl_typesupport_cpp", *ts_lib),
       options.template to_rcl_publisher_options<rclcpp::SerializedMessage>(qos)),
-    ts_lib_(ts_lib)
+    ts_lib_(ts_lib),
+    serialized_message_pool_(std::make_shared<rclcpp::detail::SerializedMessagePool>())
   {
     // This is unfortunately duplicated with the code in publisher.hpp.
     // TODO(nnmm): Deduplicate by moving this into PublisherBase.
@@ -111,13 +119,76 @@ public:
     }
   }
 
+  /// Called post construction, so that construction may continue after shared_from_this() works.
+  template<typename AllocatorT = std::allocator<void>>
+  void
+  post_init_setup(
+    rclcpp::node_interfaces::NodeBaseInterface * node_base,
+    const rclcpp::QoS & qos,
+    const rclcpp::PublisherOptionsWithAllocator<AllocatorT> & options)
+  {
+    // If needed, setup intra process communication.
+    if (rclcpp::detail::resolve_use_intra_process(options, *node_base)) {
+      auto context = node_base->get_context();
+      // Get the intra process manager instance for this context.
+      auto ipm = context->get_sub_context<rclcpp::experimental::IntraProcessManager>();
+      // Register the publisher with the intra process manager.
+      if (qos.history() != rclcpp::HistoryPolicy::KeepLast) {
+        throw std::invalid_argument(
+                "intraprocess communication allowed only with keep last history qos policy");
+      }
+      if (qos.depth() == 0) {
+        throw std::invalid_argument(
+                "intraprocess communication is not allowed with a zero qos history depth value");
+      }
+      if (qos.durability() != rclcpp::DurabilityPolicy::Volatile) {
+        throw std::invalid_argument(
+                "intraprocess communication allowed only with volatile durability");
+      }
+      uint64_t intra_process_publisher_id = ipm->add_publisher(this->shared_from_this());
+      this->setup_intra_process(
+        intra_process_publisher_id,
+        ipm);
+    }
+  }
+
   RCLCPP_PUBLIC
   virtual ~GenericPublisher() = default;
 
   /// Publish a rclcpp::SerializedMessage.
+  /**
+   * With intra-process communication enabled, the message is delivered intra-process
+   * first and only published to the middleware if other processes subscribe to it.
+   *
+   * A message referring to external memory, e.g. a memory mapped region of a bag file,
+   * is published without copying its data.
+   */
   RCLCPP_PUBLIC
   void publish(const rclcpp::SerializedMessage & message);
 
+  /// Publish a shared rclcpp::SerializedMessage.
+  /**
+   * Same as publish() taking a reference, except that intra-process subscriptions share
+   * the given message instead of a copy of it, so it must not be modified afterwards.
+   * This lets a relay forward the messages of a GenericSubscription without copying them.
+   *
+   * \param message the serialized message, must not be null.
+   * \throws std::invalid_argument if the message is null.
+   */
+  RCLCPP_PUBLIC
+  void publish(std::shared_ptr<const rclcpp::SerializedMessage> message);
+
+  /// Borrow a serialized message to write the data to publish into.
+  /**
+   * The message is empty and its buffer has at least the given capacity.
+   * It is recycled by this publisher once every reference to it is dropped, so its
+   * buffer is reused by the following calls instead of being allocated again.
+   *
+   * \param capacity the minimum capacity of the buffer.
+   */
+  RCLCPP_PUBLIC
+  std::shared_ptr<rclcpp::SerializedMessage> borrow_serialized_message(size_t capacity = 0u);
+
   /**
    * Publish a rclcpp::SerializedMessage via loaned message after de-serialization.
    *
@@ -130,7 +201,10 @@ public:
 private:
   // The type support library should stay loaded, so it is stored in the GenericPublisher
   std::shared_ptr<rcpputils::SharedLibrary> ts_lib_;
+  // Recycles the messages handed out by borrow_serialized_message()
+  std::shared_ptr<rclcpp::detail::SerializedMessagePool> serialized_message_pool_;
 
+  void publish_inter_process(const rclcpp::SerializedMessage & message);
   void * borrow_loaned_message();
   void deserialize_message(
     const rmw_serialized_message_t & serialized_message,
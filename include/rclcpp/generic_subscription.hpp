@@ -18,11 +18,16 @@
 
 #include <functional>
 #include <memory>
+#include <stdexcept>
 #include <string>
 
 #include "rcpputils/shared_library.hpp"
 
 #include "rclcpp/callback_group.hpp"
+#include "rclcpp/detail/resolve_use_intra_process.hpp"
+#include "rclcpp/detail/serialized_message_pool.hpp"
+#include "rclcpp/experimental/intra_process_manager.hpp"
+#include "rclcpp/experimental/subscription_serialized_intra_process.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
 #include "rclcpp/node_interfaces/node_topics_interface.hpp"
@@ -40,7 +45,12 @@ namespace rclcpp
  * Since the type is not known at compile time, this is not a template, and the dynamic library
  * containing type support information has to be identified and loaded based on the type name.
  *
- * It does not support intra-process handling.
+ * When intra-process communication is enabled, messages from typed publishers in the same
+ * context are serialized once per publish and shared by all the generic subscriptions.
+ *
+ * The serialized messages given to the callback are recycled once the user drops them,
+ * so their buffers keep the capacity needed by the topic and taking a message doesn't
+ * allocate in the steady state.
  */
 class GenericSubscription : public rclcpp::SubscriptionBase
 {
@@ -64,8 +74,8 @@ public:
    * \param callback Callback for new messages of serialized form
    * \param options %Subscription options.
    * Not all subscription options are currently respected, the only relevant options for this
-   * subscription are `event_callbacks`, `use_default_callbacks`, `ignore_local_publications`, and
-   * `%callback_group`.
+   * subscription are `event_callbacks`, `use_default_callbacks`, `ignore_local_publications`,
+   * `use_intra_process_comm`, and `%callback_group`.
    */
   template<typename AllocatorT = std::allocator<void>>
   GenericSubscription(
@@ -84,7 +94,8 @@ public:
       options.template to_rcl_subscription_options<rclcpp::SerializedMessage>(qos),
       true),
     callback_(callback),
-    ts_lib_(ts_lib)
+    ts_lib_(ts_lib),
+    serialized_message_pool_(std::make_shared<rclcpp::detail::SerializedMessagePool>())
   {
     // This is unfortunately duplicated with the code in subscription.hpp.
     // TODO(nnmm): Deduplicate by moving this into SubscriptionBase.
@@ -119,6 +130,38 @@ public:
         options.event_callbacks.message_lost_callback,
         RCL_SUBSCRIPTION_MESSAGE_LOST);
     }
+
+    // Setup intra process publishing if requested.
+    if (rclcpp::detail::resolve_use_intra_process(options, *node_base)) {
+      // Check if the QoS is compatible with intra-process.
+      auto qos_profile = get_actual_qos();
+      if (qos_profile.history() != rclcpp::HistoryPolicy::KeepLast) {
+        throw std::invalid_argument(
+                "intraprocess communication allowed only with keep last history qos policy");
+      }
+      if (qos_profile.depth() == 0) {
+        throw std::invalid_argument(
+                "intraprocess communication is not allowed with 0 depth qos policy");
+      }
+      if (qos_profile.durability() != rclcpp::DurabilityPolicy::Volatile) {
+        throw std::invalid_argument(
+                "intraprocess communication allowed only with volatile durability");
+      }
+
+      auto context = node_base->get_context();
+      subscription_intra_process_ =
+        std::make_shared<rclcpp::experimental::SubscriptionSerializedIntraProcess>(
+        callback_,
+        context,
+        this->get_topic_name(),  // important to get like this, as it has the fully-qualified name
+        qos_profile);
+
+      // Add it to the intra process manager.
+      using rclcpp::experimental::IntraProcessManager;
+      auto ipm = context->get_sub_context<IntraProcessManager>();
+      uint64_t intra_process_subscription_id = ipm->add_subscription(subscription_intra_process_);
+      this->setup_intra_process(intra_process_subscription_id, ipm);
+    }
   }
 
   RCLCPP_PUBLIC
@@ -161,6 +204,8 @@ private:
   std::function<void(std::shared_ptr<rclcpp::SerializedMessage>)> callback_;
   // The type support library should stay loaded, so it is stored in the GenericSubscription
   std::shared_ptr<rcpputils::SharedLibrary> ts_lib_;
+  // Recycles the messages taken from the middleware
+  std::shared_ptr<rclcpp::detail::SerializedMessagePool> serialized_message_pool_;
 };
 
 }  // namespace rclcpp
@@ -15,6 +15,9 @@
 #ifndef RCLCPP__MEMORY_STRATEGIES_HPP_
 #define RCLCPP__MEMORY_STRATEGIES_HPP_
 
+#include <memory>
+
+#include "rclcpp/executor_arena.hpp"
 #include "rclcpp/memory_strategy.hpp"
 #include "rclcpp/visibility_control.hpp"
 
@@ -31,6 +34,20 @@ RCLCPP_PUBLIC
 memory_strategy::MemoryStrategy::SharedPtr
 create_default_strategy();
 
+/// Create a MemoryStrategy which allocates from the given arena.
+/**
+ * The collected handles, the timer queue and the rcl wait set of the executor
+ * using this strategy are allocated from the arena.
+ * The arena must outlive the strategy, which the executor ensures when the
+ * arena is passed with rclcpp::ExecutorOptions::arena.
+ *
+ * \param[in] arena the arena to allocate from.
+ * \return a MemoryStrategy sharedPtr
+ */
+RCLCPP_PUBLIC
+memory_strategy::MemoryStrategy::SharedPtr
+create_arena_strategy(std::shared_ptr<rclcpp::ExecutorArena> arena);
+
 }  // namespace memory_strategies
 }  // namespace rclcpp
 
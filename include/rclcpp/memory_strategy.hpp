@@ -15,6 +15,7 @@
 #ifndef RCLCPP__MEMORY_STRATEGY_HPP_
 #define RCLCPP__MEMORY_STRATEGY_HPP_
 
+#include <chrono>
 #include <list>
 #include <map>
 #include <memory>
@@ -98,6 +99,26 @@ public:
   virtual rcl_allocator_t
   get_allocator() = 0;
 
+  /// Wait on steady clock timers by their deadline instead of adding them to the wait set.
+  /**
+   * The executor then bounds its wait with time_until_next_timer(), and the memory strategy
+   * reports the timers which are due as ready after the wait.
+   * This is not supported by default.
+   *
+   * \param[in] enabled whether timers are kept out of the wait set.
+   * \return true if the memory strategy supports the requested mode.
+   */
+  virtual bool
+  set_timer_queue_enabled(bool enabled);
+
+  /// Return how long until the earliest timer kept out of the wait set is due.
+  /**
+   * \return the time until the timer is due, zero if it is already due, or a negative
+   *   duration if there is no timer kept out of the wait set.
+   */
+  virtual std::chrono::nanoseconds
+  time_until_next_timer() const;
+
   static rclcpp::SubscriptionBase::SharedPtr
   get_subscription_by_handle(
     const std::shared_ptr<const rcl_subscription_t> & subscriber_handle,
@@ -0,0 +1,220 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__MESSAGE_FIELD_ACCESSOR_HPP_
+#define RCLCPP__MESSAGE_FIELD_ACCESSOR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+#include "rcpputils/shared_library.hpp"
+#include "rosidl_runtime_c/message_type_support_struct.h"
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Direct access to a field of a ROS message, resolved once from its type support.
+/**
+ * An accessor is only the position of the field in the C++ message structure and its
+ * type, reading the field doesn't look anything up.
+ * Nested fields are supported, arrays are not.
+ */
+class FieldAccessor
+{
+public:
+  /// Create an invalid accessor.
+  FieldAccessor() = default;
+
+  /// Create an accessor, normally done by MessageFieldAccessors::get_field().
+  /**
+   * \param[in] offset The offset of the field in the message.
+   * \param[in] type_id The rosidl_typesupport_introspection_cpp type of the field.
+   * \param[in] size The size of the field in the message.
+   */
+  FieldAccessor(size_t offset, uint8_t type_id, size_t size)
+  : offset_(offset), type_id_(type_id), size_(size)
+  {}
+
+  /// Return true if the accessor refers to a field.
+  bool
+  is_valid() const
+  {
+    return 0u != type_id_;
+  }
+
+  /// Get the offset of the field in the message.
+  size_t
+  get_offset() const
+  {
+    return offset_;
+  }
+
+  /// Get the rosidl_typesupport_introspection_cpp type of the field, e.g. ROS_TYPE_INT32.
+  uint8_t
+  get_type_id() const
+  {
+    return type_id_;
+  }
+
+  /// Get the size of the field in the message.
+  size_t
+  get_size() const
+  {
+    return size_;
+  }
+
+  /// Get the address of the field in the given message, without any check.
+  const void *
+  get_pointer(const void * ros_message) const
+  {
+    return static_cast<const uint8_t *>(ros_message) + offset_;
+  }
+
+  /// Get a reference to the field in the given message.
+  /**
+   * \tparam T The C++ type of the field, e.g. `int32_t`, `std::string`, or
+   *   `builtin_interfaces::msg::Time` for a nested message.
+   * \throws std::invalid_argument if T can't be the type of the field.
+   */
+  template<typename T>
+  const T &
+  get(const void * ros_message) const
+  {
+    if (!holds_type<T>()) {
+      throw std::invalid_argument("field accessed with a type it doesn't hold");
+    }
+    return *static_cast<const T *>(get_pointer(ros_message));
+  }
+
+  /// Return true if T can be the type of the field.
+  /**
+   * Fields holding nested messages are only checked for their size.
+   */
+  template<typename T>
+  bool
+  holds_type() const
+  {
+    if (sizeof(T) != size_) {
+      return false;
+    }
+    if constexpr (std::is_same<T, bool>::value) {
+      return type_id_ == boolean_type_id;
+    } else if constexpr (std::is_floating_point<T>::value) {
+      return type_id_ >= float_type_id && type_id_ <= long_double_type_id;
+    } else if constexpr (std::is_integral<T>::value || std::is_same<T, char16_t>::value) {
+      return type_id_ >= char_type_id && type_id_ <= int64_type_id &&
+             type_id_ != boolean_type_id;
+    } else if constexpr (std::is_same<T, std::string>::value) {
+      return type_id_ == string_type_id;
+    } else if constexpr (std::is_same<T, std::u16string>::value) {
+      return type_id_ == wstring_type_id;
+    } else {
+      return type_id_ == message_type_id;
+    }
+  }
+
+private:
+  // Values of the rosidl_typesupport_introspection_cpp field types used above,
+  // kept here so that this header doesn't depend on it.
+  static constexpr uint8_t float_type_id = 1u;
+  static constexpr uint8_t long_double_type_id = 3u;
+  static constexpr uint8_t char_type_id = 4u;
+  static constexpr uint8_t boolean_type_id = 6u;
+  static constexpr uint8_t int64_type_id = 15u;
+  static constexpr uint8_t string_type_id = 16u;
+  static constexpr uint8_t wstring_type_id = 17u;
+  static constexpr uint8_t message_type_id = 18u;
+
+  size_t offset_ = 0u;
+  uint8_t type_id_ = 0u;
+  size_t size_ = 0u;
+};
+
+/// The field accessors of a ROS message type.
+/**
+ * Fields are resolved from the rosidl_typesupport_introspection_cpp metadata of the
+ * type the first time they are requested, and memoized.
+ * This class is thread-safe.
+ */
+class MessageFieldAccessors
+{
+public:
+  RCLCPP_SMART_PTR_ALIASES_ONLY(MessageFieldAccessors)
+
+  /// Constructor.
+  /**
+   * \param[in] type_support The type support of the messages, for any type support
+   *   which can provide the rosidl_typesupport_introspection_cpp one.
+   * \param[in] library The library providing the type support, kept loaded.
+   * \throws std::invalid_argument if the introspection type support is not available.
+   */
+  RCLCPP_PUBLIC
+  explicit MessageFieldAccessors(
+    const rosidl_message_type_support_t & type_support,
+    std::shared_ptr<rcpputils::SharedLibrary> library = nullptr);
+
+  RCLCPP_PUBLIC
+  ~MessageFieldAccessors();
+
+  /// Get the accessor of a field.
+  /**
+   * \param[in] path The name of the field, nested fields are separated by dots,
+   *   e.g. "header.stamp".
+   * \throws std::invalid_argument if there is no such field or if it is in an array.
+   */
+  RCLCPP_PUBLIC
+  FieldAccessor
+  get_field(const std::string & path) const;
+
+  /// Get the size of the C++ message structure.
+  RCLCPP_PUBLIC
+  size_t
+  get_message_size() const;
+
+private:
+  RCLCPP_DISABLE_COPY(MessageFieldAccessors)
+
+  FieldAccessor
+  resolve_field(const std::string & path) const;
+
+  std::shared_ptr<rcpputils::SharedLibrary> library_;
+  const void * members_;
+  mutable std::mutex mutex_;
+  mutable std::unordered_map<std::string, FieldAccessor> fields_;
+};
+
+/// Get the field accessors of a ROS message type, shared by the whole process.
+/**
+ * The accessors are created the first time a type is requested, loading its
+ * introspection type support library, and then reused.
+ *
+ * \param[in] type The message type, e.g. "sensor_msgs/msg/PointCloud2".
+ * \throws std::runtime_error if the type support library can't be loaded.
+ */
+RCLCPP_PUBLIC
+MessageFieldAccessors::ConstSharedPtr
+get_message_field_accessors(const std::string & type);
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__MESSAGE_FIELD_ACCESSOR_HPP_
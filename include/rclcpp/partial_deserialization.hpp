@@ -0,0 +1,111 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__PARTIAL_DESERIALIZATION_HPP_
+#define RCLCPP__PARTIAL_DESERIALIZATION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rcl/types.h"
+
+#include "rosidl_runtime_c/message_type_support_struct.h"
+
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Interface to deserialize only some fields of a serialized message
+/**
+ * Reading stops right after the last requested field, so getting the header of a
+ * large message, like an image, doesn't depend on the size of the message.
+ * The fields which are not requested are left untouched in the ROS message.
+ *
+ * Fields are given by name, nested fields being separated by dots, e.g.
+ * `{"header.stamp", "header.frame_id"}`.
+ * A field holding a message is deserialized entirely, and so are arrays.
+ *
+ * Messages are decoded by rclcpp instead of rmw, so they must use the plain CDR
+ * encoding of rmw_fastrtps_cpp and rmw_cyclonedds_cpp.
+ * The fields of types `long double`, `wchar` and `wstring` can't be read, nor the
+ * ones which follow them.
+ */
+class RCLCPP_PUBLIC_TYPE PartialDeserializationBase
+{
+public:
+  /// Constructor of PartialDeserializationBase
+  /**
+   * \param[in] type_support handle for the message type support, for any type support
+   *   which can provide the rosidl_typesupport_introspection_cpp one.
+   * \param[in] fields the fields to be deserialized.
+   * \throws std::invalid_argument if a field doesn't exist or can't be read, or if the
+   *   introspection type support is not available.
+   */
+  PartialDeserializationBase(
+    const rosidl_message_type_support_t * type_support,
+    const std::vector<std::string> & fields);
+
+  /// Destructor of PartialDeserializationBase
+  virtual ~PartialDeserializationBase();
+
+  /// Deserialize the requested fields of a serialized message
+  /**
+   * \param[in] serialized_message The serialized message to be read.
+   * \param[out] ros_message The ROS2 message whose requested fields are set.
+   * \throws std::runtime_error if the message is truncated or not CDR encoded.
+   */
+  void deserialize_message(
+    const SerializedMessage * serialized_message, void * ros_message) const;
+
+  /// Deserialize the requested fields of a serialized message not owned by rclcpp
+  /**
+   * \sa rclcpp::make_serialized_message_view()
+   *
+   * \param[in] serialized_message The serialized message to be read.
+   * \param[out] ros_message The ROS2 message whose requested fields are set.
+   * \throws std::runtime_error if the message is truncated or not CDR encoded.
+   */
+  void deserialize_message_view(
+    const rcl_serialized_message_t * serialized_message, void * ros_message) const;
+
+private:
+  struct Plan;
+  std::shared_ptr<const Plan> plan_;
+};
+
+/// Deserialize only some fields of serialized messages of the given type
+template<typename MessageT>
+class PartialDeserialization : public PartialDeserializationBase
+{
+public:
+  /// Constructor of PartialDeserialization
+  /**
+   * \param[in] fields the fields to be deserialized.
+   */
+  explicit PartialDeserialization(const std::vector<std::string> & fields)
+  : PartialDeserializationBase(
+      rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>(), fields)
+  {}
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__PARTIAL_DESERIALIZATION_HPP_
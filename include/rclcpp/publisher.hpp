@@ -31,6 +31,7 @@
 
 #include "rclcpp/allocator/allocator_common.hpp"
 #include "rclcpp/allocator/allocator_deleter.hpp"
+#include "rclcpp/async_publish_queue.hpp"
 #include "rclcpp/detail/resolve_use_intra_process.hpp"
 #include "rclcpp/experimental/intra_process_manager.hpp"
 #include "rclcpp/get_message_type_support_handle.hpp"
@@ -40,6 +41,7 @@
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
 #include "rclcpp/publisher_base.hpp"
 #include "rclcpp/publisher_options.hpp"
+#include "rclcpp/publishing_thread_pool.hpp"
 #include "rclcpp/type_adapter.hpp"
 #include "rclcpp/type_support_decl.hpp"
 #include "rclcpp/visibility_control.hpp"
@@ -139,6 +141,19 @@ public:
     allocator::set_allocator_for_deleter(&published_type_deleter_, &published_type_allocator_);
     allocator::set_allocator_for_deleter(&ros_message_type_deleter_, &ros_message_type_allocator_);
 
+    if (options_.async_publish.enabled) {
+      async_publish_queue_ = std::make_shared<rclcpp::AsyncPublishQueue>(
+        publisher_handle_, options_.async_publish);
+    }
+
+    if constexpr (rclcpp::TypeAdapter<MessageT>::is_specialized::value) {
+      if (options_.defer_ros_message_conversion) {
+        publishing_thread_pool_ = options_.publishing_thread_pool ?
+          options_.publishing_thread_pool :
+          rclcpp::PublishingThreadPool::get_default_instance(node_base->get_context());
+      }
+    }
+
     if (options_.event_callbacks.deadline_callback) {
       this->add_event_handler(
         options_.event_callbacks.deadline_callback,
@@ -251,7 +266,7 @@ public:
   publish(std::unique_ptr<T, ROSMessageTypeDeleter> msg)
   {
     if (!intra_process_is_enabled_) {
-      this->do_inter_process_publish(*msg);
+      this->do_inter_process_publish(std::move(msg));
       return;
     }
     // If an interprocess subscription exist, then the unique_ptr is promoted
@@ -266,7 +281,7 @@ public:
     if (inter_process_publish_needed) {
       auto shared_msg =
         this->do_intra_process_ros_message_publish_and_return_shared(std::move(msg));
-      this->do_inter_process_publish(*shared_msg);
+      this->do_inter_process_publish(std::move(shared_msg));
     } else {
       this->do_intra_process_ros_message_publish(std::move(msg));
     }
@@ -324,7 +339,7 @@ public:
   publish(std::unique_ptr<T, ROSMessageTypeDeleter> msg,std::unique_ptr<rclcpp::MessageInfo> message_info)
   {
     if (!intra_process_is_enabled_) {
-      this->do_inter_process_publish(*msg);
+      this->do_inter_process_publish(std::move(msg));
       return;
     }
     // If an interprocess subscription exist, then the unique_ptr is promoted
@@ -339,7 +354,7 @@ public:
     if (inter_process_publish_needed) {
       auto shared_msg =
         this->do_intra_process_ros_message_publish_and_return_shared(std::move(msg), std::make_unique<rclcpp::MessageInfo>(*message_info));
-      this->do_inter_process_publish(*shared_msg);
+      this->do_inter_process_publish(std::move(shared_msg));
     } else {
       this->do_intra_process_ros_message_publish(std::move(msg), std::move(message_info));
     }
@@ -365,8 +380,75 @@ public:
     this->publish(std::move(unique_msg), std::move(message_info));
   }
 
+  /// Publish a message of the custom_type of a TypeAdapter, with its message info.
+  /**
+   * This signature is enabled if this class was created with a TypeAdapter and
+   * the element_type of the std::unique_ptr matches the custom_type for the
+   * TypeAdapter used with this class.
+   *
+   * The message is given to the intra-process subscriptions with its message
+   * info, and is only converted to the ROS message type if there are
+   * inter-process subscriptions.
+   *
+   * \param[in] msg A unique pointer to the message to send.
+   * \param[in] message_info The message info, with its timepoints.
+   */
+  template<typename T>
+  typename std::enable_if_t<
+    rclcpp::TypeAdapter<MessageT>::is_specialized::value &&
+    std::is_same<T, PublishedType>::value
+  >
+  publish(
+    std::unique_ptr<T, PublishedTypeDeleter> msg,
+    std::unique_ptr<rclcpp::MessageInfo> message_info)
+  {
+    if (!intra_process_is_enabled_) {
+      if (publishing_thread_pool_) {
+        return this->do_deferred_inter_process_publish(std::move(msg));
+      }
+      ROSMessageType ros_msg;
+      rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*msg, ros_msg);
+      return this->do_inter_process_publish(std::move(ros_msg));
+    }
+
+    bool inter_process_publish_needed =
+      get_subscription_count() > get_intra_process_subscription_count();
+
+    if (inter_process_publish_needed && publishing_thread_pool_) {
+      // The ROS message converted for the intra-process subscriptions, if any, is reused.
+      std::shared_ptr<const ROSMessageType> ros_msg;
+      auto shared_msg = this->do_intra_process_publish_and_return_shared(
+        std::move(msg), std::move(message_info), &ros_msg);
+      this->do_deferred_inter_process_publish(std::move(shared_msg), std::move(ros_msg));
+    } else if (inter_process_publish_needed) {
+      // Converted once, for the inter-process publish and the intra-process subscriptions
+      // expecting the ROS message type.
+      std::shared_ptr<const ROSMessageType> ros_msg = this->convert_to_shared_ros_message(*msg);
+      this->do_intra_process_publish(std::move(msg), std::move(message_info), &ros_msg);
+      this->do_inter_process_publish(std::move(ros_msg));
+    } else {
+      this->do_intra_process_publish(std::move(msg), std::move(message_info));
+    }
+  }
+
+  template<typename T>
+  typename std::enable_if_t<
+    rclcpp::TypeAdapter<MessageT>::is_specialized::value &&
+    std::is_same<T, PublishedType>::value
+  >
+  publish(const T & msg, std::unique_ptr<rclcpp::MessageInfo> message_info)
+  {
+    // Avoid double allocating when not using intra process.
+    if (!intra_process_is_enabled_ && !publishing_thread_pool_) {
+      ROSMessageType ros_msg;
+      rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(msg, ros_msg);
+      return this->do_inter_process_publish(std::move(ros_msg));
+    }
+
+    auto unique_msg = this->duplicate_type_adapt_message_as_unique_ptr(msg);
+    this->publish(std::move(unique_msg), std::move(message_info));
+  }
   #endif
-  // we dont support TypeAdapter in interneuron now, but it is easy to add it
 
   /// Publish a message on the topic.
   /**
@@ -388,23 +470,30 @@ public:
   {
     // Avoid allocating when not using intra process.
     if (!intra_process_is_enabled_) {
+      if (publishing_thread_pool_) {
+        return this->do_deferred_inter_process_publish(std::move(msg));
+      }
       // In this case we're not using intra process.
       ROSMessageType ros_msg;
       rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*msg, ros_msg);
-      return this->do_inter_process_publish(ros_msg);
+      return this->do_inter_process_publish(std::move(ros_msg));
     }
 
     bool inter_process_publish_needed =
       get_subscription_count() > get_intra_process_subscription_count();
 
-    if (inter_process_publish_needed) {
-      ROSMessageType ros_msg;
-      // TODO(clalancette): This is unnecessarily doing an additional conversion
-      // that may have already been done in do_intra_process_publish_and_return_shared().
-      // We should just reuse that effort.
-      rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*msg, ros_msg);
-      this->do_intra_process_publish(std::move(msg));
-      this->do_inter_process_publish(ros_msg);
+    if (inter_process_publish_needed && publishing_thread_pool_) {
+      // Deliver intra-process first, and leave the conversion to the publishing thread,
+      // unless it was already done for the intra-process subscriptions.
+      std::shared_ptr<const ROSMessageType> ros_msg;
+      auto shared_msg = this->do_intra_process_publish_and_return_shared(std::move(msg), &ros_msg);
+      this->do_deferred_inter_process_publish(std::move(shared_msg), std::move(ros_msg));
+    } else if (inter_process_publish_needed) {
+      // Converted once, for the inter-process publish and the intra-process subscriptions
+      // expecting the ROS message type.
+      std::shared_ptr<const ROSMessageType> ros_msg = this->convert_to_shared_ros_message(*msg);
+      this->do_intra_process_publish(std::move(msg), &ros_msg);
+      this->do_inter_process_publish(std::move(ros_msg));
     } else {
       this->do_intra_process_publish(std::move(msg));
     }
@@ -429,12 +518,13 @@ public:
   publish(const T & msg)
   {
     // Avoid double allocating when not using intra process.
-    if (!intra_process_is_enabled_) {
+    // The deferred publish needs a copy which outlives the call anyway.
+    if (!intra_process_is_enabled_ && !publishing_thread_pool_) {
       // Convert to the ROS message equivalent and publish it.
       ROSMessageType ros_msg;
       rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(msg, ros_msg);
       // In this case we're not using intra process.
-      return this->do_inter_process_publish(ros_msg);
+      return this->do_inter_process_publish(std::move(ros_msg));
     }
 
     // Otherwise we have to allocate memory in a unique_ptr and pass it along.
@@ -510,20 +600,78 @@ public:
     return ros_message_type_allocator_;
   }
 
+  /// Get the metrics of the asynchronous inter-process publishes.
+  /**
+   * \throws std::runtime_error if the publisher wasn't created with
+   *   PublisherOptionsBase::async_publish enabled.
+   */
+  AsyncPublishStatistics
+  get_async_publish_statistics() const
+  {
+    if (!async_publish_queue_) {
+      throw std::runtime_error("asynchronous publishing is not enabled for this publisher");
+    }
+    return async_publish_queue_->get_statistics();
+  }
+
 protected:
 #ifdef INTERNEURON
 //todo
 #endif
   void
   do_inter_process_publish(const ROSMessageType & msg)
+  {
+    if (async_publish_queue_) {
+      // The message is queued, so it has to be copied.
+      async_publish_queue_->push(
+        std::allocate_shared<ROSMessageType>(ros_message_type_allocator_, msg));
+      return;
+    }
+    do_inter_process_publish(publisher_handle_.get(), msg);
+  }
+
+  void
+  do_inter_process_publish(ROSMessageType && msg)
+  {
+    if (async_publish_queue_) {
+      async_publish_queue_->push(
+        std::allocate_shared<ROSMessageType>(ros_message_type_allocator_, std::move(msg)));
+      return;
+    }
+    do_inter_process_publish(publisher_handle_.get(), msg);
+  }
+
+  void
+  do_inter_process_publish(std::unique_ptr<ROSMessageType, ROSMessageTypeDeleter> msg)
+  {
+    if (async_publish_queue_) {
+      async_publish_queue_->push(std::move(msg));
+      return;
+    }
+    do_inter_process_publish(publisher_handle_.get(), *msg);
+  }
+
+  void
+  do_inter_process_publish(std::shared_ptr<const ROSMessageType> msg)
+  {
+    if (async_publish_queue_) {
+      async_publish_queue_->push(std::move(msg));
+      return;
+    }
+    do_inter_process_publish(publisher_handle_.get(), *msg);
+  }
+
+  static
+  void
+  do_inter_process_publish(rcl_publisher_t * publisher_handle, const ROSMessageType & msg)
   {
     TRACEPOINT(rclcpp_publish, nullptr, static_cast<const void *>(&msg));
-    auto status = rcl_publish(publisher_handle_.get(), &msg, nullptr);
+    auto status = rcl_publish(publisher_handle, &msg, nullptr);
 
     if (RCL_RET_PUBLISHER_INVALID == status) {
       rcl_reset_error();  // next call will reset error message if not context
-      if (rcl_publisher_is_valid_except_context(publisher_handle_.get())) {
-        rcl_context_t * context = rcl_publisher_get_context(publisher_handle_.get());
+      if (rcl_publisher_is_valid_except_context(publisher_handle)) {
+        rcl_context_t * context = rcl_publisher_get_context(publisher_handle);
         if (nullptr != context && !rcl_context_is_valid(context)) {
           // publisher is invalid due to context being shutdown
           return;
@@ -535,12 +683,61 @@ protected:
     }
   }
 
+  /// Convert a custom_type message and publish it inter-process on the publishing thread pool.
+  /**
+   * \param[in] msg The message to publish.
+   * \param[in] ros_msg The ROS message msg was already converted to, if any, which is
+   *   published instead of converting msg again.
+   */
+  void
+  do_deferred_inter_process_publish(
+    std::shared_ptr<const PublishedType> msg,
+    std::shared_ptr<const ROSMessageType> ros_msg = nullptr)
+  {
+    if (!msg) {
+      // The intra process publish failed, and already said why.
+      return;
+    }
+    // The publisher handle is kept alive by the task, the publisher may be gone when it runs.
+    if (ros_msg) {
+      publishing_thread_pool_->enqueue(
+        publisher_handle_.get(),
+        [publisher_handle = publisher_handle_, async_publish_queue = async_publish_queue_,
+        ros_msg = std::move(ros_msg)]() {
+          if (async_publish_queue) {
+            async_publish_queue->push(std::move(ros_msg));
+            return;
+          }
+          do_inter_process_publish(publisher_handle.get(), *ros_msg);
+        });
+      return;
+    }
+    publishing_thread_pool_->enqueue(
+      publisher_handle_.get(),
+      [publisher_handle = publisher_handle_, async_publish_queue = async_publish_queue_,
+      msg = std::move(msg)]() {
+        if (async_publish_queue) {
+          auto ros_msg = std::make_shared<ROSMessageType>();
+          rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*msg, *ros_msg);
+          async_publish_queue->push(std::move(ros_msg));
+          return;
+        }
+        ROSMessageType ros_msg;
+        rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*msg, ros_msg);
+        do_inter_process_publish(publisher_handle.get(), ros_msg);
+      });
+  }
+
   void
   do_serialized_publish(const rcl_serialized_message_t * serialized_msg)
   {
     if (intra_process_is_enabled_) {
-      // TODO(Karsten1987): support serialized message passed by intraprocess
-      throw std::runtime_error("storing serialized messages in intra process is not supported yet");
+      bool inter_process_publish_needed =
+        get_subscription_count() > get_intra_process_subscription_count();
+      this->do_serialized_intra_process_publish(*serialized_msg);
+      if (!inter_process_publish_needed) {
+        return;
+      }
     }
     auto status = rcl_publish_serialized_message(publisher_handle_.get(), serialized_msg, nullptr);
     if (RCL_RET_OK != status) {
@@ -570,7 +767,9 @@ protected:
   }
 
   void
-  do_intra_process_publish(std::unique_ptr<PublishedType, PublishedTypeDeleter> msg)
+  do_intra_process_publish(
+    std::unique_ptr<PublishedType, PublishedTypeDeleter> msg,
+    std::shared_ptr<const ROSMessageType> * ros_msg = nullptr)
   {
     auto ipm = weak_ipm_.lock();
     if (!ipm) {
@@ -584,7 +783,8 @@ protected:
     ipm->template do_intra_process_publish<PublishedType, ROSMessageType, AllocatorT>(
       intra_process_publisher_id_,
       std::move(msg),
-      published_type_allocator_);
+      published_type_allocator_,
+      ros_msg);
   }
 
   void
@@ -605,6 +805,28 @@ protected:
       ros_message_type_allocator_);
   }
 
+  std::shared_ptr<const PublishedType>
+  do_intra_process_publish_and_return_shared(
+    std::unique_ptr<PublishedType, PublishedTypeDeleter> msg,
+    std::shared_ptr<const ROSMessageType> * ros_msg = nullptr)
+  {
+    auto ipm = weak_ipm_.lock();
+    if (!ipm) {
+      throw std::runtime_error(
+              "intra process publish called after destruction of intra process manager");
+    }
+    if (!msg) {
+      throw std::runtime_error("cannot publish msg which is a null pointer");
+    }
+
+    return ipm->template do_intra_process_publish_and_return_shared<PublishedType, ROSMessageType,
+             AllocatorT>(
+      intra_process_publisher_id_,
+      std::move(msg),
+      published_type_allocator_,
+      ros_msg);
+  }
+
   std::shared_ptr<const ROSMessageType>
   do_intra_process_ros_message_publish_and_return_shared(
     std::unique_ptr<ROSMessageType, ROSMessageTypeDeleter> msg)
@@ -626,7 +848,8 @@ protected:
   }
 #ifdef INTERNEURON
 void
-  do_intra_process_publish(std::unique_ptr<PublishedType, PublishedTypeDeleter> msg,std::unique_ptr<rclcpp::MessageInfo> message_info)
+  do_intra_process_publish(std::unique_ptr<PublishedType, PublishedTypeDeleter> msg,std::unique_ptr<rclcpp::MessageInfo> message_info,
+    std::shared_ptr<const ROSMessageType> * ros_msg = nullptr)
   {
     auto ipm = weak_ipm_.lock();
     if (!ipm) {
@@ -641,7 +864,8 @@ void
       intra_process_publisher_id_,
       std::move(msg),
       published_type_allocator_,
-      std::move(message_info));
+      std::move(message_info),
+      ros_msg);
   }
 
   void
@@ -663,6 +887,30 @@ void
       std::move(message_info));
   }
 
+  std::shared_ptr<const PublishedType>
+  do_intra_process_publish_and_return_shared(
+    std::unique_ptr<PublishedType, PublishedTypeDeleter> msg,
+    std::unique_ptr<rclcpp::MessageInfo> message_info,
+    std::shared_ptr<const ROSMessageType> * ros_msg = nullptr)
+  {
+    auto ipm = weak_ipm_.lock();
+    if (!ipm) {
+      throw std::runtime_error(
+              "intra process publish called after destruction of intra process manager");
+    }
+    if (!msg || !message_info) {
+      throw std::runtime_error("cannot publish msg and message_info which is a null pointer");
+    }
+
+    return ipm->template do_intra_process_publish_and_return_shared<PublishedType, ROSMessageType,
+             AllocatorT>(
+      intra_process_publisher_id_,
+      std::move(msg),
+      published_type_allocator_,
+      std::move(message_info),
+      ros_msg);
+  }
+
   std::shared_ptr<const ROSMessageType>
   do_intra_process_ros_message_publish_and_return_shared(
     std::unique_ptr<ROSMessageType, ROSMessageTypeDeleter> msg,std::unique_ptr<rclcpp::MessageInfo> message_info)
@@ -684,6 +932,16 @@ void
       std::move(message_info));
   }
 #endif
+  /// Convert a custom_type message to a new shared ROS message.
+  std::shared_ptr<const ROSMessageType>
+  convert_to_shared_ros_message(const PublishedType & msg)
+  {
+    auto ros_msg = std::allocate_shared<ROSMessageType, ROSMessageTypeAllocator>(
+      ros_message_type_allocator_);
+    rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(msg, *ros_msg);
+    return ros_msg;
+  }
+
   /// Return a new unique_ptr using the ROSMessageType of the publisher.
   std::unique_ptr<ROSMessageType, ROSMessageTypeDeleter>
   create_ros_message_unique_ptr()
@@ -722,6 +980,12 @@ void
   PublishedTypeDeleter published_type_deleter_;
   ROSMessageTypeAllocator ros_message_type_allocator_;
   ROSMessageTypeDeleter ros_message_type_deleter_;
+
+  /// Thread pool of the deferred conversions, set only if they are enabled.
+  std::shared_ptr<rclcpp::PublishingThreadPool> publishing_thread_pool_;
+
+  /// Queue of the asynchronous inter-process publishes, set only if they are enabled.
+  std::shared_ptr<rclcpp::AsyncPublishQueue> async_publish_queue_;
 };
 
 }  // namespace rclcpp
@@ -34,6 +34,7 @@
 #include "rclcpp/network_flow_endpoint.hpp"
 #include "rclcpp/qos.hpp"
 #include "rclcpp/qos_event.hpp"
+#include "rclcpp/serialized_message.hpp"
 #include "rclcpp/type_support_decl.hpp"
 #include "rclcpp/visibility_control.hpp"
 #include "rcpputils/time.hpp"
@@ -335,6 +336,27 @@ protected:
 
   RCLCPP_PUBLIC
   void default_incompatible_qos_callback(QOSOfferedIncompatibleQoSInfo & info) const;
+
+  /// Give a serialized message to the intra-process subscriptions matched with this publisher.
+  /**
+   * The message is copied once and then shared by all the subscriptions.
+   *
+   * \param serialized_msg the serialized message to deliver.
+   * \throws std::runtime_error if the intra process manager was destroyed.
+   */
+  RCLCPP_PUBLIC
+  void
+  do_serialized_intra_process_publish(const rcl_serialized_message_t & serialized_msg);
+
+  /// Share a serialized message with the intra-process subscriptions of this publisher.
+  /**
+   * \param serialized_msg the serialized message to deliver, it must not be modified later.
+   * \throws std::runtime_error if the intra process manager was destroyed.
+   */
+  RCLCPP_PUBLIC
+  void
+  do_serialized_intra_process_publish(
+    std::shared_ptr<const rclcpp::SerializedMessage> serialized_msg);
   std::shared_ptr<rcl_node_t> rcl_node_handle_;
 
   std::shared_ptr<rcl_publisher_t> publisher_handle_;
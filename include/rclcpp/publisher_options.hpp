@@ -23,8 +23,10 @@
 #include "rcl/publisher.h"
 
 #include "rclcpp/allocator/allocator_common.hpp"
+#include "rclcpp/async_publish_queue.hpp"
 #include "rclcpp/detail/rmw_implementation_specific_publisher_payload.hpp"
 #include "rclcpp/intra_process_setting.hpp"
+#include "rclcpp/publishing_thread_pool.hpp"
 #include "rclcpp/qos.hpp"
 #include "rclcpp/qos_event.hpp"
 #include "rclcpp/qos_overriding_options.hpp"
@@ -59,6 +61,33 @@ struct PublisherOptionsBase
   rmw_implementation_payload = nullptr;
 
   QosOverridingOptions qos_overriding_options;
+
+  /// Convert TypeAdapter messages to ROS messages and publish them inter-process on a thread.
+  /**
+   * Only used by the publishers created with a TypeAdapter, when publishing the custom type.
+   * The calling thread then only does the intra-process delivery, and the inter-process
+   * publish happens later, on publishing_thread_pool.
+   * Errors of the deferred publishes are logged instead of thrown.
+   * Messages published as the ROS message type are still published on the calling thread,
+   * and may be sent before the deferred ones.
+   * Disabled by default.
+   */
+  bool defer_ros_message_conversion = false;
+
+  /// Thread pool running the deferred publishes.
+  /// If not set, the PublishingThreadPool::get_default_instance() of the context is used.
+  std::shared_ptr<rclcpp::PublishingThreadPool> publishing_thread_pool = nullptr;
+
+  /// Queue the inter-process publishes, to be done by a background thread.
+  /**
+   * The calling thread then never waits for the middleware, and intra-process delivery
+   * is still done by the calling thread.
+   * Serialized messages, and loaned messages the middleware can take, are still published
+   * synchronously.
+   * Disabled by default.
+   * \sa rclcpp::AsyncPublishQueue
+   */
+  AsyncPublishOptions async_publish;
 };
 
 /// Structure containing optional configuration for Publishers.
@@ -0,0 +1,137 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__PUBLISHING_THREAD_POOL_HPP_
+#define RCLCPP__PUBLISHING_THREAD_POOL_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/context.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Threads running the publishing work deferred by publishers.
+/**
+ * Publishers created with PublisherOptionsBase::defer_ros_message_conversion
+ * give it the conversion of their TypeAdapter messages to ROS messages and
+ * their inter-process publishes.
+ *
+ * Every task is given a key, and the tasks with the same key are run in order on
+ * the same thread, so the messages of a publisher are never reordered.
+ * Exceptions thrown by the tasks are logged and dropped.
+ *
+ * The queues of the threads are unbounded: tasks queued faster than they run,
+ * e.g. because the conversions are slower than the publishing rate, pile up
+ * without limit, see get_number_of_pending_tasks().
+ * Only the inter-process publishes can be bounded, by enabling the
+ * asynchronous publish queue of the publishers, see AsyncPublishOptions.
+ *
+ * This class is thread-safe.
+ */
+class PublishingThreadPool
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(PublishingThreadPool)
+
+  /// Start the threads of the pool.
+  /**
+   * \param[in] number_of_threads The number of threads, at least one.
+   * \throws std::invalid_argument if number_of_threads is zero.
+   */
+  RCLCPP_PUBLIC
+  explicit PublishingThreadPool(size_t number_of_threads = 1);
+
+  /// Run the queued tasks and stop the threads, see shutdown().
+  RCLCPP_PUBLIC
+  virtual ~PublishingThreadPool();
+
+  /// Run the queued tasks and stop the threads.
+  /**
+   * This blocks until the queued tasks are run, and the tasks queued afterwards
+   * are dropped.
+   * Calling it again does nothing.
+   */
+  RCLCPP_PUBLIC
+  void
+  shutdown();
+
+  /// Queue a task to be run by the thread of the given key.
+  /**
+   * This never blocks, as the queue is unbounded, and only drops the task once the pool
+   * is shut down.
+   *
+   * \param[in] key The key ordering the task, e.g. the address of the publisher.
+   * \param[in] task The task to run.
+   */
+  RCLCPP_PUBLIC
+  void
+  enqueue(const void * key, std::function<void()> task);
+
+  /// Get the number of threads of the pool.
+  RCLCPP_PUBLIC
+  size_t
+  get_number_of_threads() const;
+
+  /// Get the number of tasks queued and not run yet.
+  RCLCPP_PUBLIC
+  size_t
+  get_number_of_pending_tasks() const;
+
+  /// Get the pool shared by the publishers of a context which aren't given one.
+  /**
+   * The pool has a single thread, and is shut down before the context, so the
+   * deferred publishes are done while the context is still valid.
+   * The publishers created after the context is shut down and initialized again get
+   * a new pool.
+   *
+   * \param[in] context The context of the publishers.
+   * \return The default pool of the context.
+   */
+  RCLCPP_PUBLIC
+  static
+  SharedPtr
+  get_default_instance(const rclcpp::Context::SharedPtr & context);
+
+private:
+  RCLCPP_DISABLE_COPY(PublishingThreadPool)
+
+  struct Worker
+  {
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::function<void()>> tasks;
+    bool stop = false;
+    std::thread thread;
+  };
+
+  void
+  run(Worker & worker);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::mutex shutdown_mutex_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__PUBLISHING_THREAD_POOL_HPP_
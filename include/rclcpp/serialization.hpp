@@ -15,10 +15,13 @@
 #ifndef RCLCPP__SERIALIZATION_HPP_
 #define RCLCPP__SERIALIZATION_HPP_
 
+#include <cstdint>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
+#include "rclcpp/serialized_message_batch.hpp"
 #include "rclcpp/visibility_control.hpp"
 
 #include "rcl/types.h"
@@ -74,6 +77,27 @@ public:
   void deserialize_message(
     const SerializedMessage * serialized_message, void * ros_message) const;
 
+  /// Serialize a ROS2 message and append it to a batch
+  /**
+   * The message is first serialized into the scratch message of the batch, whose
+   * capacity is reused by the following calls.
+   *
+   * \param[in] ros_message The ROS2 message which is read and serialized by rmw.
+   * \param[out] batch The batch the serialized message is appended to.
+   */
+  void serialize_message_to_batch(
+    const void * ros_message, SerializedMessageBatch * batch) const;
+
+  /// Deserialize a serialized stream which is not owned by a SerializedMessage
+  /**
+   * \sa rclcpp::make_serialized_message_view()
+   *
+   * \param[in] serialized_message The non owning serialized message to be converted to ROS2.
+   * \param[out] ros_message The deserialized ROS2 message.
+   */
+  void deserialize_message_view(
+    const rcl_serialized_message_t * serialized_message, void * ros_message) const;
+
 private:
   const rosidl_message_type_support_t * type_support_;
 };
@@ -91,6 +115,59 @@ public:
       !serialization_traits::is_serialized_message_class<MessageT>::value,
       "Serialization of serialized message to serialized message is not possible.");
   }
+
+  /// Serialize a range of ROS2 messages, appending them to a batch
+  /**
+   * \param[in] first The beginning of the range of messages.
+   * \param[in] last The end of the range of messages.
+   * \param[out] batch The batch the serialized messages are appended to.
+   */
+  template<typename InputIt>
+  void serialize_batch(InputIt first, InputIt last, SerializedMessageBatch & batch) const
+  {
+    for (; first != last; ++first) {
+      const MessageT & ros_message = *first;
+      serialize_message_to_batch(&ros_message, &batch);
+    }
+  }
+
+  /// Deserialize the messages stored in a memory region, like a memory mapped file
+  /**
+   * The messages vector is resized to the number of entries and the messages are
+   * deserialized in place, so that the memory they hold is reused when the same vector
+   * is passed again.
+   *
+   * \param[in] region The start of the memory region.
+   * \param[in] region_size The size of the memory region.
+   * \param[in] entries The position of every serialized message in the region.
+   * \param[out] ros_messages The deserialized ROS2 messages.
+   * \throws std::out_of_range if an entry is not within the region.
+   */
+  void deserialize_batch(
+    const void * region,
+    size_t region_size,
+    const std::vector<SerializedMessageBatch::Entry> & entries,
+    std::vector<MessageT> & ros_messages) const
+  {
+    const auto * base = static_cast<const uint8_t *>(region);
+    ros_messages.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+      const auto & entry = entries[i];
+      if (entry.offset > region_size || entry.size > region_size - entry.offset) {
+        throw std::out_of_range("serialized message is not within the memory region");
+      }
+      const auto view = make_serialized_message_view(base + entry.offset, entry.size);
+      deserialize_message_view(&view, &ros_messages[i]);
+    }
+  }
+
+  /// Deserialize all the messages of a batch
+  void deserialize_batch(
+    const SerializedMessageBatch & batch,
+    std::vector<MessageT> & ros_messages) const
+  {
+    deserialize_batch(batch.data(), batch.bytes(), batch.entries(), ros_messages);
+  }
 };
 
 }  // namespace rclcpp
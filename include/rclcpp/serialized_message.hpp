@@ -15,6 +15,9 @@
 #ifndef RCLCPP__SERIALIZED_MESSAGE_HPP_
 #define RCLCPP__SERIALIZED_MESSAGE_HPP_
 
+#include <cstddef>
+#include <memory>
+
 #include "rcl/allocator.h"
 #include "rcl/types.h"
 
@@ -51,7 +54,27 @@ public:
     size_t initial_capacity,
     const rcl_allocator_t & allocator = rcl_get_default_allocator());
 
+  /// Constructor for a SerializedMessage referring to read-only memory it doesn't own
+  /**
+   * This wraps memory like a region of a memory mapped file without copying it.
+   * The owner is kept alive as long as this message or a copy of it refers to the memory,
+   * releasing the last reference to it is the release hook of the region, e.g. a custom
+   * deleter unmapping it.
+   *
+   * The memory is never written to: the non const accessors first copy the data into a
+   * buffer owned by this message, and copies of the message share the memory.
+   *
+   * \param[in] data The start of the serialized data.
+   * \param[in] size The size of the serialized data.
+   * \param[in] owner The owner of the memory, must not be null.
+   * \throws std::invalid_argument if data or owner are null.
+   */
+  SerializedMessage(const void * data, size_t size, std::shared_ptr<const void> owner);
+
   /// Copy Constructor for a SerializedMessage
+  /**
+   * Messages referring to external memory are copied without copying the data.
+   */
   SerializedMessage(const SerializedMessage & other);
 
   /// Constructor for a SerializedMessage from a rcl_serialized_message_t
@@ -79,6 +102,10 @@ public:
   virtual ~SerializedMessage();
 
   /// Get the underlying rcl_serialized_t handle
+  /**
+   * If the message refers to external memory, the data is copied first into a buffer
+   * owned by this message, as the caller may modify it.
+   */
   rcl_serialized_message_t & get_rcl_serialized_message();
 
   // Get a const handle to the underlying rcl_serialized_message_t
@@ -109,11 +136,20 @@ public:
   /**
    * The memory (i.e. the data buffer) of the serialized message will no longer
    * be managed by this instance and the memory won't be deallocated on destruction.
+   * External memory is copied first, the returned buffer is always allocated.
    */
   rcl_serialized_message_t release_rcl_serialized_message();
 
+  /// Return true if the data is external memory this message doesn't own
+  bool is_external() const;
+
 private:
+  /// Copy external data into a buffer owned by this message, if needed.
+  void detach_external_buffer();
+
   rcl_serialized_message_t serialized_message_;
+  /// Owner of the external memory, null if the buffer is owned by this message.
+  std::shared_ptr<const void> external_owner_;
 };
 
 }  // namespace rclcpp
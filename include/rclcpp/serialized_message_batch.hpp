@@ -0,0 +1,125 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__SERIALIZED_MESSAGE_BATCH_HPP_
+#define RCLCPP__SERIALIZED_MESSAGE_BATCH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "rcl/allocator.h"
+#include "rcl/types.h"
+
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Several serialized messages stored back to back in one contiguous buffer.
+/**
+ * Each message is described by an entry holding its offset and size in the buffer.
+ * Every message starts at an offset which is a multiple of `alignment`, so the buffer
+ * can be written to a file as is and memory mapped by a reader later.
+ *
+ * The buffer and the scratch message used while serializing keep their capacity when
+ * the batch is cleared, so a batch reused for messages of similar sizes stops
+ * allocating after the first few rounds.
+ */
+class RCLCPP_PUBLIC_TYPE SerializedMessageBatch
+{
+public:
+  /// Position of a message in the buffer of a batch.
+  struct Entry
+  {
+    size_t offset;
+    size_t size;
+  };
+
+  /// Alignment of the start of every message in the buffer.
+  static constexpr size_t alignment = 8;
+
+  /// Constructor.
+  /**
+   * \param[in] initial_capacity The amount of memory to be allocated for the buffer.
+   * \param[in] allocator The allocator to be used for the buffers.
+   */
+  explicit SerializedMessageBatch(
+    size_t initial_capacity = 0u,
+    const rcl_allocator_t & allocator = rcl_get_default_allocator());
+
+  /// Append a copy of a serialized message to the batch.
+  void append(const rcl_serialized_message_t & serialized_message);
+
+  /// Append a copy of a serialized message to the batch.
+  void append(const SerializedMessage & serialized_message);
+
+  /// Remove all the messages, keeping the allocated memory.
+  void clear();
+
+  /// Allocate memory in the buffer, it never shrinks.
+  void reserve(size_t capacity);
+
+  /// Get the number of messages in the batch.
+  size_t size() const;
+
+  /// Return true if there is no message in the batch.
+  bool empty() const;
+
+  /// Get the number of bytes used in the buffer, padding included.
+  size_t bytes() const;
+
+  /// Get the size of allocated memory for the buffer.
+  size_t capacity() const;
+
+  /// Get the start of the buffer.
+  const uint8_t * data() const;
+
+  /// Get the position of every message in the buffer.
+  const std::vector<Entry> & entries() const;
+
+  /// Get a non owning view of the message at the given index.
+  /**
+   * The view is invalidated by the next call modifying the batch.
+   *
+   * \throws std::out_of_range if the index is not smaller than size().
+   */
+  rcl_serialized_message_t view(size_t index) const;
+
+  /// Get the scratch message serializers write into before the message is appended.
+  SerializedMessage & get_scratch_message();
+
+private:
+  SerializedMessage buffer_;
+  SerializedMessage scratch_;
+  std::vector<Entry> entries_;
+};
+
+/// Get a non owning serialized message referring to existing memory.
+/**
+ * This is meant to deserialize messages out of memory that rclcpp doesn't own, like a
+ * memory mapped file, without copying them.
+ * The returned message must not be finalized nor resized.
+ *
+ * \param[in] data The start of the serialized message.
+ * \param[in] size The size of the serialized message.
+ */
+RCLCPP_PUBLIC
+rcl_serialized_message_t
+make_serialized_message_view(const void * data, size_t size);
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__SERIALIZED_MESSAGE_BATCH_HPP_
@@ -15,10 +15,18 @@
 #ifndef RCLCPP__STRATEGIES__ALLOCATOR_MEMORY_STRATEGY_HPP_
 #define RCLCPP__STRATEGIES__ALLOCATOR_MEMORY_STRATEGY_HPP_
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "rcl/allocator.h"
+#include "rcl/error_handling.h"
+#include "rcl/timer.h"
+#include "rcutils/time.h"
 
 #include "rclcpp/allocator/allocator_common.hpp"
 #include "rclcpp/detail/add_guard_condition_to_rcl_wait_set.hpp"
@@ -57,7 +65,16 @@ public:
   using VoidAllocTraits = typename allocator::AllocRebind<void *, Alloc>;
   using VoidAlloc = typename VoidAllocTraits::allocator_type;
 
+  /// Allocate the handles collected on each spin, and the rcl wait set, with the allocator.
   explicit AllocatorMemoryStrategy(std::shared_ptr<Alloc> allocator)
+  : guard_conditions_(*allocator),
+    subscription_handles_(*allocator),
+    service_handles_(*allocator),
+    client_handles_(*allocator),
+    timer_handles_(*allocator),
+    waitable_handles_(*allocator),
+    timer_queue_(*allocator),
+    queued_timers_(*allocator)
   {
     allocator_ = std::make_shared<VoidAlloc>(*allocator.get());
   }
@@ -106,58 +123,107 @@ public:
     // The same logic applies for other entities.
     for (size_t i = 0; i < subscription_handles_.size(); ++i) {
       if (!wait_set->subscriptions[i]) {
-        subscription_handles_[i].reset();
+        subscription_handles_[i].handle.reset();
       }
     }
     for (size_t i = 0; i < service_handles_.size(); ++i) {
       if (!wait_set->services[i]) {
-        service_handles_[i].reset();
+        service_handles_[i].handle.reset();
       }
     }
     for (size_t i = 0; i < client_handles_.size(); ++i) {
       if (!wait_set->clients[i]) {
-        client_handles_[i].reset();
+        client_handles_[i].handle.reset();
       }
     }
     for (size_t i = 0; i < timer_handles_.size(); ++i) {
       if (!wait_set->timers[i]) {
-        timer_handles_[i].reset();
+        timer_handles_[i].handle.reset();
       }
     }
     for (size_t i = 0; i < waitable_handles_.size(); ++i) {
-      if (!waitable_handles_[i]->is_ready(wait_set)) {
-        waitable_handles_[i].reset();
+      if (!waitable_handles_[i].waitable->is_ready(wait_set)) {
+        waitable_handles_[i].waitable.reset();
       }
     }
 
     subscription_handles_.erase(
-      std::remove(subscription_handles_.begin(), subscription_handles_.end(), nullptr),
+      std::remove_if(
+        subscription_handles_.begin(), subscription_handles_.end(),
+        [](const auto & collected) {return !collected.handle;}),
       subscription_handles_.end()
     );
 
     service_handles_.erase(
-      std::remove(service_handles_.begin(), service_handles_.end(), nullptr),
+      std::remove_if(
+        service_handles_.begin(), service_handles_.end(),
+        [](const auto & collected) {return !collected.handle;}),
       service_handles_.end()
     );
 
     client_handles_.erase(
-      std::remove(client_handles_.begin(), client_handles_.end(), nullptr),
+      std::remove_if(
+        client_handles_.begin(), client_handles_.end(),
+        [](const auto & collected) {return !collected.handle;}),
       client_handles_.end()
     );
 
     timer_handles_.erase(
-      std::remove(timer_handles_.begin(), timer_handles_.end(), nullptr),
+      std::remove_if(
+        timer_handles_.begin(), timer_handles_.end(),
+        [](const auto & collected) {return !collected.handle;}),
       timer_handles_.end()
     );
 
     waitable_handles_.erase(
-      std::remove(waitable_handles_.begin(), waitable_handles_.end(), nullptr),
+      std::remove_if(
+        waitable_handles_.begin(), waitable_handles_.end(),
+        [](const CollectedWaitable & collected) {return !collected.waitable;}),
       waitable_handles_.end()
     );
+
+    // Report the queued timers which are due as ready, in deadline order.
+    if (!timer_queue_.empty()) {
+      rcutils_time_point_value_t now;
+      if (rcutils_steady_time_now(&now) != RCUTILS_RET_OK) {
+        rcutils_reset_error();
+        return;
+      }
+      while (!timer_queue_.empty() && timer_queue_.front().deadline <= now) {
+        std::pop_heap(timer_queue_.begin(), timer_queue_.end(), QueuedTimer::later);
+        QueuedTimer & due = timer_queue_.back();
+        auto queued = queued_timers_.find(due.collected.entity);
+        auto timer = due.collected.entity.lock();
+        int64_t deadline = 0;
+        if (!timer || queued == queued_timers_.end()) {
+          if (queued != queued_timers_.end()) {
+            queued_timers_.erase(queued);
+          }
+        } else if (!get_timer_deadline(due.collected.handle.get(), *timer, deadline)) {
+          // Canceled while queued, queued again when collected next time.
+          queued->second.is_queued = false;
+        } else if (deadline > now) {
+          // Reset, or its period changed, while queued, so it isn't ready yet and calling it
+          // would run its callback early: wait for its new deadline instead.
+          due.deadline = deadline;
+          std::push_heap(timer_queue_.begin(), timer_queue_.end(), QueuedTimer::later);
+          continue;
+        } else {
+          // Queued again with its next deadline when collected next time.
+          queued->second.is_queued = false;
+          // Report it with the group it was last collected from, which may have changed.
+          due.collected.group = queued->second.group;
+          due.collected.node = queued->second.node;
+          timer_handles_.push_back(std::move(due.collected));
+        }
+        timer_queue_.pop_back();
+      }
+    }
   }
 
   bool collect_entities(const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes) override
   {
+    ++collect_generation_;
     bool has_invalid_weak_groups_or_nodes = false;
     for (const auto & pair : weak_groups_to_nodes) {
       auto group = pair.first.lock();
@@ -170,24 +236,66 @@ public:
         continue;
       }
 
+      // Record the group and node along with each handle, so that the executor resolves ready
+      // handles without searching every group.
+      // Capturing only two pointers keeps the std::function objects from allocating.
       group->collect_all_ptrs(
-        [this](const rclcpp::SubscriptionBase::SharedPtr & subscription) {
-          subscription_handles_.push_back(subscription->get_subscription_handle());
+        [this, &pair](const rclcpp::SubscriptionBase::SharedPtr & subscription) {
+          subscription_handles_.push_back(
+            {subscription->get_subscription_handle(), subscription, pair.first, pair.second});
         },
-        [this](const rclcpp::ServiceBase::SharedPtr & service) {
-          service_handles_.push_back(service->get_service_handle());
+        [this, &pair](const rclcpp::ServiceBase::SharedPtr & service) {
+          service_handles_.push_back(
+            {service->get_service_handle(), service, pair.first, pair.second});
         },
-        [this](const rclcpp::ClientBase::SharedPtr & client) {
-          client_handles_.push_back(client->get_client_handle());
+        [this, &pair](const rclcpp::ClientBase::SharedPtr & client) {
+          client_handles_.push_back(
+            {client->get_client_handle(), client, pair.first, pair.second});
         },
-        [this](const rclcpp::TimerBase::SharedPtr & timer) {
-          timer_handles_.push_back(timer->get_timer_handle());
+        [this, &pair](const rclcpp::TimerBase::SharedPtr & timer) {
+          if (timer_queue_enabled_ && queue_timer(timer, pair.first, pair.second)) {
+            return;
+          }
+          timer_handles_.push_back(
+            {timer->get_timer_handle(), timer, pair.first, pair.second});
         },
-        [this](const rclcpp::Waitable::SharedPtr & waitable) {
-          waitable_handles_.push_back(waitable);
+        [this, &pair](const rclcpp::Waitable::SharedPtr & waitable) {
+          waitable_handles_.push_back({waitable, pair.first, pair.second});
         });
     }
 
+    // Drop the queued timers which weren't collected this time, because their group was
+    // removed from the executor or can't be taken from, or because they were destroyed.
+    // The others are queued again when collected next time.
+    auto not_collected = std::remove_if(
+      timer_queue_.begin(), timer_queue_.end(),
+      [this](const QueuedTimer & queued_timer) {
+        auto queued = queued_timers_.find(queued_timer.collected.entity);
+        if (queued == queued_timers_.end()) {
+          return true;
+        }
+        if (queued->second.collect_generation == collect_generation_) {
+          return false;
+        }
+        queued->second.is_queued = false;
+        return true;
+      });
+    if (not_collected != timer_queue_.end()) {
+      timer_queue_.erase(not_collected, timer_queue_.end());
+      std::make_heap(timer_queue_.begin(), timer_queue_.end(), QueuedTimer::later);
+    }
+
+    // Forget the destroyed timers which were not queued, canceled ones for instance.
+    if (queued_timers_.size() > 2 * timer_queue_.size() + 16) {
+      for (auto it = queued_timers_.begin(); it != queued_timers_.end(); ) {
+        if (!it->second.is_queued && it->first.expired()) {
+          it = queued_timers_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+
     return has_invalid_weak_groups_or_nodes;
   }
 
@@ -196,13 +304,14 @@ public:
     if (nullptr == waitable) {
       throw std::runtime_error("waitable object unexpectedly nullptr");
     }
-    waitable_handles_.push_back(waitable);
+    // Not collected from a group, so get_next_waitable() never returns it.
+    waitable_handles_.push_back({waitable, {}, {}});
   }
 
   bool add_handles_to_wait_set(rcl_wait_set_t * wait_set) override
   {
-    for (const std::shared_ptr<const rcl_subscription_t> & subscription : subscription_handles_) {
-      if (rcl_wait_set_add_subscription(wait_set, subscription.get(), NULL) != RCL_RET_OK) {
+    for (const auto & collected : subscription_handles_) {
+      if (rcl_wait_set_add_subscription(wait_set, collected.handle.get(), NULL) != RCL_RET_OK) {
         RCUTILS_LOG_ERROR_NAMED(
           "rclcpp",
           "Couldn't add subscription to wait set: %s", rcl_get_error_string().str);
@@ -210,8 +319,8 @@ public:
       }
     }
 
-    for (const std::shared_ptr<const rcl_client_t> & client : client_handles_) {
-      if (rcl_wait_set_add_client(wait_set, client.get(), NULL) != RCL_RET_OK) {
+    for (const auto & collected : client_handles_) {
+      if (rcl_wait_set_add_client(wait_set, collected.handle.get(), NULL) != RCL_RET_OK) {
         RCUTILS_LOG_ERROR_NAMED(
           "rclcpp",
           "Couldn't add client to wait set: %s", rcl_get_error_string().str);
@@ -219,8 +328,8 @@ public:
       }
     }
 
-    for (const std::shared_ptr<const rcl_service_t> & service : service_handles_) {
-      if (rcl_wait_set_add_service(wait_set, service.get(), NULL) != RCL_RET_OK) {
+    for (const auto & collected : service_handles_) {
+      if (rcl_wait_set_add_service(wait_set, collected.handle.get(), NULL) != RCL_RET_OK) {
         RCUTILS_LOG_ERROR_NAMED(
           "rclcpp",
           "Couldn't add service to wait set: %s", rcl_get_error_string().str);
@@ -228,8 +337,8 @@ public:
       }
     }
 
-    for (const std::shared_ptr<const rcl_timer_t> & timer : timer_handles_) {
-      if (rcl_wait_set_add_timer(wait_set, timer.get(), NULL) != RCL_RET_OK) {
+    for (const auto & collected : timer_handles_) {
+      if (rcl_wait_set_add_timer(wait_set, collected.handle.get(), NULL) != RCL_RET_OK) {
         RCUTILS_LOG_ERROR_NAMED(
           "rclcpp",
           "Couldn't add timer to wait set: %s", rcl_get_error_string().str);
@@ -241,8 +350,8 @@ public:
       detail::add_guard_condition_to_rcl_wait_set(*wait_set, *guard_condition);
     }
 
-    for (const std::shared_ptr<Waitable> & waitable : waitable_handles_) {
-      waitable->add_to_wait_set(wait_set);
+    for (const CollectedWaitable & collected : waitable_handles_) {
+      collected.waitable->add_to_wait_set(wait_set);
     }
     return true;
   }
@@ -252,6 +361,8 @@ public:
     rclcpp::AnyExecutable & any_exec,
     const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes) override
   {
+    // The entity, group and node of each handle were recorded by collect_entities().
+    (void) weak_groups_to_nodes;
     auto it = subscription_handles_.begin();
 
 #ifdef PICAS
@@ -261,10 +372,10 @@ public:
     #endif
 #endif
     while (it != subscription_handles_.end()) {
-      auto subscription = get_subscription_by_handle(*it, weak_groups_to_nodes);
+      auto subscription = it->entity.lock();
       if (subscription) {
-        // Find the group for this handle and see if it can be serviced
-        auto group = get_group_by_subscription(subscription, weak_groups_to_nodes);
+        // Check if the group the handle was collected from can be serviced
+        auto group = it->group.lock();
         if (!group) {
           // Group was not found, meaning the subscription is not valid...
           // Remove it from the ready list and continue looking
@@ -284,13 +395,13 @@ public:
             highest_priority = subscription->callback_priority;
             any_exec.subscription = subscription;
             any_exec.callback_group = group;
-            any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+            any_exec.node_base = it->node.lock();
           }
         } else {
           // Otherwise it is safe to set and return the any_exec
           any_exec.subscription = subscription;
           any_exec.callback_group = group;
-          any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+          any_exec.node_base = it->node.lock();
           subscription_handles_.erase(it);
           #ifdef PICAS_DEBUG
           RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "[get_next_subscription found (node name: %s)", any_exec.node_base->get_name());
@@ -302,7 +413,7 @@ public:
         // Otherwise it is safe to set and return the any_exec
         any_exec.subscription = subscription;
         any_exec.callback_group = group;
-        any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+        any_exec.node_base = it->node.lock();
         subscription_handles_.erase(it);
         return;
 #endif
@@ -324,6 +435,8 @@ public:
     rclcpp::AnyExecutable & any_exec,
     const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes) override
   {
+    // The entity, group and node of each handle were recorded by collect_entities().
+    (void) weak_groups_to_nodes;
     auto it = service_handles_.begin();
     #ifdef PICAS
     int highest_priority = -1;
@@ -332,10 +445,10 @@ public:
     #endif
 #endif
     while (it != service_handles_.end()) {
-      auto service = get_service_by_handle(*it, weak_groups_to_nodes);
+      auto service = it->entity.lock();
       if (service) {
-        // Find the group for this handle and see if it can be serviced
-        auto group = get_group_by_service(service, weak_groups_to_nodes);
+        // Check if the group the handle was collected from can be serviced
+        auto group = it->group.lock();
         if (!group) {
           // Group was not found, meaning the service is not valid...
           // Remove it from the ready list and continue looking
@@ -356,13 +469,13 @@ public:
             highest_priority = service->callback_priority;
             any_exec.service = service;
             any_exec.callback_group = group;
-            any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+            any_exec.node_base = it->node.lock();
           }
         } else {
           // Otherwise it is safe to set and return the any_exec
           any_exec.service = service;
           any_exec.callback_group = group;
-          any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+          any_exec.node_base = it->node.lock();
           service_handles_.erase(it);
           #ifdef PICAS_DEBUG
           RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "[get_next_service] found (node name: %s)", any_exec.node_base->get_name());
@@ -374,7 +487,7 @@ public:
         // Otherwise it is safe to set and return the any_exec
         any_exec.service = service;
         any_exec.callback_group = group;
-        any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+        any_exec.node_base = it->node.lock();
         service_handles_.erase(it);
         return;
 #endif
@@ -395,6 +508,8 @@ public:
     rclcpp::AnyExecutable & any_exec,
     const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes) override
   {
+    // The entity, group and node of each handle were recorded by collect_entities().
+    (void) weak_groups_to_nodes;
     auto it = client_handles_.begin();
     #ifdef PICAS
     int highest_priority = -1;
@@ -403,10 +518,10 @@ public:
     #endif
 #endif
     while (it != client_handles_.end()) {
-      auto client = get_client_by_handle(*it, weak_groups_to_nodes);
+      auto client = it->entity.lock();
       if (client) {
-        // Find the group for this handle and see if it can be serviced
-        auto group = get_group_by_client(client, weak_groups_to_nodes);
+        // Check if the group the handle was collected from can be serviced
+        auto group = it->group.lock();
         if (!group) {
           // Group was not found, meaning the service is not valid...
           // Remove it from the ready list and continue looking
@@ -427,13 +542,13 @@ public:
             highest_priority = client->callback_priority;
             any_exec.client = client;
             any_exec.callback_group = group;
-            any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+            any_exec.node_base = it->node.lock();
           }
         } else {
           // Otherwise it is safe to set and return the any_exec
           any_exec.client = client;
           any_exec.callback_group = group;
-          any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+          any_exec.node_base = it->node.lock();
           client_handles_.erase(it);
           #ifdef PICAS_DEBUG
           RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "[get_next_client] found (node name: %s)", any_exec.node_base->get_name());
@@ -444,7 +559,7 @@ public:
         // Otherwise it is safe to set and return the any_exec
         any_exec.client = client;
         any_exec.callback_group = group;
-        any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+        any_exec.node_base = it->node.lock();
         client_handles_.erase(it);
         return;
 #endif
@@ -464,6 +579,8 @@ public:
     rclcpp::AnyExecutable & any_exec,
     const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes) override
   {
+    // The entity, group and node of each handle were recorded by collect_entities().
+    (void) weak_groups_to_nodes;
     auto it = timer_handles_.begin();
     #ifdef PICAS
     int highest_priority = -1;
@@ -473,10 +590,10 @@ public:
 #endif
 
     while (it != timer_handles_.end()) {
-      auto timer = get_timer_by_handle(*it, weak_groups_to_nodes);
+      auto timer = it->entity.lock();
       if (timer) {
-        // Find the group for this handle and see if it can be serviced
-        auto group = get_group_by_timer(timer, weak_groups_to_nodes);
+        // Check if the group the handle was collected from can be serviced
+        auto group = it->group.lock();
         if (!group) {
           // Group was not found, meaning the timer is not valid...
           // Remove it from the ready list and continue looking
@@ -501,13 +618,13 @@ public:
             highest_priority = timer->callback_priority;
             any_exec.timer = timer;
             any_exec.callback_group = group;
-            any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+            any_exec.node_base = it->node.lock();
           }
         } else {
           // Otherwise it is safe to set and return the any_exec
           any_exec.timer = timer;
           any_exec.callback_group = group;
-          any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+          any_exec.node_base = it->node.lock();
           timer_handles_.erase(it);
           #ifdef PICAS_DEBUG
           RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "[get_next_timer] found (node name: %s)", any_exec.node_base->get_name());
@@ -519,7 +636,7 @@ public:
         // Otherwise it is safe to set and return the any_exec
         any_exec.timer = timer;
         any_exec.callback_group = group;
-        any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+        any_exec.node_base = it->node.lock();
         timer_handles_.erase(it);
         return;
 #endif
@@ -540,6 +657,8 @@ public:
     rclcpp::AnyExecutable & any_exec,
     const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes) override
   {
+    // The entity, group and node of each handle were recorded by collect_entities().
+    (void) weak_groups_to_nodes;
     auto it = waitable_handles_.begin();
     #ifdef PICAS
     int highest_priority = -1;
@@ -549,10 +668,10 @@ public:
 #endif
 
     while (it != waitable_handles_.end()) {
-      std::shared_ptr<Waitable> & waitable = *it;
+      std::shared_ptr<Waitable> & waitable = it->waitable;
       if (waitable) {
-        // Find the group for this handle and see if it can be serviced
-        auto group = get_group_by_waitable(waitable, weak_groups_to_nodes);
+        // Check if the group the handle was collected from can be serviced
+        auto group = it->group.lock();
         if (!group) {
           // Group was not found, meaning the waitable is not valid...
           // Remove it from the ready list and continue looking
@@ -572,13 +691,13 @@ public:
             highest_priority = waitable->callback_priority;
             any_exec.waitable = waitable;
             any_exec.callback_group = group;
-            any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+            any_exec.node_base = it->node.lock();
           }
         } else {
           // Otherwise it is safe to set and return the any_exec
           any_exec.waitable = waitable;
           any_exec.callback_group = group;
-          any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+          any_exec.node_base = it->node.lock();
           waitable_handles_.erase(it);
           #ifdef PICAS_DEBUG
           RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "[get_next_waitable] found (node name: %s)", any_exec.node_base->get_name());
@@ -590,7 +709,7 @@ public:
         // Otherwise it is safe to set and return the any_exec
         any_exec.waitable = waitable;
         any_exec.callback_group = group;
-        any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+        any_exec.node_base = it->node.lock();
         waitable_handles_.erase(it);
         return;
 #endif
@@ -610,11 +729,41 @@ public:
     return rclcpp::allocator::get_rcl_allocator<void *, VoidAlloc>(*allocator_.get());
   }
 
+  /// Keep steady clock timers in a queue ordered by deadline instead of in the wait set.
+  /**
+   * The wait then no longer goes through every timer, and only the due timers are checked
+   * after it.
+   * This must not be enabled while the memory strategy is used by a
+   * StaticSingleThreadedExecutor, which relies on every timer being in the wait set.
+   */
+  bool set_timer_queue_enabled(bool enabled) override
+  {
+    timer_queue_enabled_ = enabled;
+    if (!enabled) {
+      timer_queue_.clear();
+      queued_timers_.clear();
+    }
+    return true;
+  }
+
+  std::chrono::nanoseconds time_until_next_timer() const override
+  {
+    if (timer_queue_.empty()) {
+      return std::chrono::nanoseconds(-1);
+    }
+    rcutils_time_point_value_t now;
+    if (rcutils_steady_time_now(&now) != RCUTILS_RET_OK) {
+      rcutils_reset_error();
+      return std::chrono::nanoseconds::zero();
+    }
+    return std::chrono::nanoseconds(std::max<int64_t>(timer_queue_.front().deadline - now, 0));
+  }
+
   size_t number_of_ready_subscriptions() const override
   {
     size_t number_of_subscriptions = subscription_handles_.size();
-    for (const std::shared_ptr<Waitable> & waitable : waitable_handles_) {
-      number_of_subscriptions += waitable->get_number_of_ready_subscriptions();
+    for (const CollectedWaitable & collected : waitable_handles_) {
+      number_of_subscriptions += collected.waitable->get_number_of_ready_subscriptions();
     }
     return number_of_subscriptions;
   }
@@ -622,8 +771,8 @@ public:
   size_t number_of_ready_services() const override
   {
     size_t number_of_services = service_handles_.size();
-    for (const std::shared_ptr<Waitable> & waitable : waitable_handles_) {
-      number_of_services += waitable->get_number_of_ready_services();
+    for (const CollectedWaitable & collected : waitable_handles_) {
+      number_of_services += collected.waitable->get_number_of_ready_services();
     }
     return number_of_services;
   }
@@ -631,8 +780,8 @@ public:
   size_t number_of_ready_events() const override
   {
     size_t number_of_events = 0;
-    for (const std::shared_ptr<Waitable> & waitable : waitable_handles_) {
-      number_of_events += waitable->get_number_of_ready_events();
+    for (const CollectedWaitable & collected : waitable_handles_) {
+      number_of_events += collected.waitable->get_number_of_ready_events();
     }
     return number_of_events;
   }
@@ -640,8 +789,8 @@ public:
   size_t number_of_ready_clients() const override
   {
     size_t number_of_clients = client_handles_.size();
-    for (const std::shared_ptr<Waitable> & waitable : waitable_handles_) {
-      number_of_clients += waitable->get_number_of_ready_clients();
+    for (const CollectedWaitable & collected : waitable_handles_) {
+      number_of_clients += collected.waitable->get_number_of_ready_clients();
     }
     return number_of_clients;
   }
@@ -649,8 +798,8 @@ public:
   size_t number_of_guard_conditions() const override
   {
     size_t number_of_guard_conditions = guard_conditions_.size();
-    for (const std::shared_ptr<Waitable> & waitable : waitable_handles_) {
-      number_of_guard_conditions += waitable->get_number_of_ready_guard_conditions();
+    for (const CollectedWaitable & collected : waitable_handles_) {
+      number_of_guard_conditions += collected.waitable->get_number_of_ready_guard_conditions();
     }
     return number_of_guard_conditions;
   }
@@ -658,8 +807,8 @@ public:
   size_t number_of_ready_timers() const override
   {
     size_t number_of_timers = timer_handles_.size();
-    for (const std::shared_ptr<Waitable> & waitable : waitable_handles_) {
-      number_of_timers += waitable->get_number_of_ready_timers();
+    for (const CollectedWaitable & collected : waitable_handles_) {
+      number_of_timers += collected.waitable->get_number_of_ready_timers();
     }
     return number_of_timers;
   }
@@ -674,13 +823,133 @@ private:
   using VectorRebind =
     std::vector<T, typename std::allocator_traits<Alloc>::template rebind_alloc<T>>;
 
+  template<typename KeyT, typename T, typename CompareT>
+  using MapRebind = std::map<KeyT, T, CompareT,
+      typename std::allocator_traits<Alloc>::template rebind_alloc<std::pair<const KeyT, T>>>;
+
   VectorRebind<const rclcpp::GuardCondition *> guard_conditions_;
 
-  VectorRebind<std::shared_ptr<const rcl_subscription_t>> subscription_handles_;
-  VectorRebind<std::shared_ptr<const rcl_service_t>> service_handles_;
-  VectorRebind<std::shared_ptr<const rcl_client_t>> client_handles_;
-  VectorRebind<std::shared_ptr<const rcl_timer_t>> timer_handles_;
-  VectorRebind<std::shared_ptr<Waitable>> waitable_handles_;
+  /// A handle to wait on, with the entity, callback group and node it was collected from.
+  template<typename HandleT, typename EntityT>
+  struct CollectedHandle
+  {
+    std::shared_ptr<const HandleT> handle;
+    typename EntityT::WeakPtr entity;
+    rclcpp::CallbackGroup::WeakPtr group;
+    rclcpp::node_interfaces::NodeBaseInterface::WeakPtr node;
+  };
+
+  /// A waitable, with the callback group and node it was collected from.
+  struct CollectedWaitable
+  {
+    std::shared_ptr<Waitable> waitable;
+    rclcpp::CallbackGroup::WeakPtr group;
+    rclcpp::node_interfaces::NodeBaseInterface::WeakPtr node;
+  };
+
+  VectorRebind<CollectedHandle<rcl_subscription_t, rclcpp::SubscriptionBase>>
+  subscription_handles_;
+  VectorRebind<CollectedHandle<rcl_service_t, rclcpp::ServiceBase>> service_handles_;
+  VectorRebind<CollectedHandle<rcl_client_t, rclcpp::ClientBase>> client_handles_;
+  VectorRebind<CollectedHandle<rcl_timer_t, rclcpp::TimerBase>> timer_handles_;
+  VectorRebind<CollectedWaitable> waitable_handles_;
+
+  /// A timer kept out of the wait set, with the steady time at which it is called.
+  struct QueuedTimer
+  {
+    int64_t deadline;
+    CollectedHandle<rcl_timer_t, rclcpp::TimerBase> collected;
+
+    /// Order of the heap, which puts the earliest deadline first.
+    static bool later(const QueuedTimer & a, const QueuedTimer & b)
+    {
+      return a.deadline > b.deadline;
+    }
+  };
+
+  /// What is known of a timer run on the steady clock.
+  struct QueuedTimerState
+  {
+    /// Whether it is in timer_queue_.
+    bool is_queued = false;
+    /// The last call to collect_entities() which collected it.
+    uint64_t collect_generation = 0;
+    /// The group and node it was last collected from.
+    rclcpp::CallbackGroup::WeakPtr group;
+    rclcpp::node_interfaces::NodeBaseInterface::WeakPtr node;
+  };
+
+  /// Queue the timer if it runs on the steady clock and isn't queued already.
+  /**
+   * \return false if the timer has to be added to the wait set instead.
+   */
+  bool queue_timer(
+    const rclcpp::TimerBase::SharedPtr & timer,
+    const rclcpp::CallbackGroup::WeakPtr & group,
+    const rclcpp::node_interfaces::NodeBaseInterface::WeakPtr & node)
+  {
+    auto timer_handle = timer->get_timer_handle();
+    rcl_clock_t * clock = nullptr;
+    if (rcl_timer_clock(const_cast<rcl_timer_t *>(timer_handle.get()), &clock) != RCL_RET_OK) {
+      rcl_reset_error();
+      return false;
+    }
+    if (clock->type != RCL_STEADY_TIME) {
+      return false;
+    }
+    // Timers are only looked up here when collected, so this doesn't scan them all.
+    QueuedTimerState & state = queued_timers_.emplace(timer, QueuedTimerState{}).first->second;
+    state.collect_generation = collect_generation_;
+    state.group = group;
+    state.node = node;
+    if (state.is_queued) {
+      return true;
+    }
+    int64_t deadline;
+    if (!get_timer_deadline(timer_handle.get(), *timer, deadline)) {
+      // The timer is canceled, check it again when collected next time.
+      return true;
+    }
+    state.is_queued = true;
+    timer_queue_.push_back({deadline, {timer_handle, timer, group, node}});
+    std::push_heap(timer_queue_.begin(), timer_queue_.end(), QueuedTimer::later);
+    return true;
+  }
+
+  /// Get the steady time at which the timer is to be called, from its next call time.
+  /**
+   * The next call time is read again each time, as resetting the timer or changing its period
+   * changes it.
+   * \return false if the timer is canceled.
+   */
+  static bool get_timer_deadline(
+    const rcl_timer_t * timer_handle,
+    const rclcpp::TimerBase & timer,
+    int64_t & deadline)
+  {
+    int64_t next_call_time;
+    if (rcl_timer_get_next_call_time(timer_handle, &next_call_time) != RCL_RET_OK) {
+      rcl_reset_error();
+      return false;
+    }
+    // Round the deadline up to a multiple of the slack, so that timers with compatible slacks
+    // become due at the same time and are called in the same wake up.
+    const int64_t slack = timer.get_slack().count();
+    deadline = next_call_time;
+    if (slack > 0 && next_call_time > 0) {
+      deadline = ((next_call_time - 1) / slack + 1) * slack;
+    }
+    return true;
+  }
+
+  bool timer_queue_enabled_ = false;
+  /// Min-heap of the queued timers by deadline.
+  VectorRebind<QueuedTimer> timer_queue_;
+  /// Timers run on the steady clock, and their state.
+  MapRebind<rclcpp::TimerBase::WeakPtr, QueuedTimerState,
+    std::owner_less<rclcpp::TimerBase::WeakPtr>>
+  queued_timers_;
+  uint64_t collect_generation_ = 0;
 
   std::shared_ptr<VoidAlloc> allocator_;
 };
@@ -15,7 +15,15 @@
 #ifndef RCLCPP__STRATEGIES__MESSAGE_POOL_MEMORY_STRATEGY_HPP_
 #define RCLCPP__STRATEGIES__MESSAGE_POOL_MEMORY_STRATEGY_HPP_
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <vector>
 
 #include "rosidl_runtime_cpp/traits.hpp"
 
@@ -30,12 +38,41 @@ namespace strategies
 namespace message_pool_memory_strategy
 {
 
+/// What MessagePoolMemoryStrategy does when a message is borrowed while all are in use.
+enum class PoolExhaustedPolicy
+{
+  /// Throw std::runtime_error.
+  Throw,
+  /// Allocate a new message and keep it in the pool once it is returned.
+  Grow,
+  /// Allocate a new message with the message allocator, which is released once it is returned.
+  Allocate,
+};
+
+/// Usage of a MessagePoolMemoryStrategy, for sizing the pool.
+struct MessagePoolStatistics
+{
+  /// Number of preallocated messages.
+  size_t size;
+  /// Number of preallocated messages currently borrowed.
+  size_t in_use;
+  /// Largest number of preallocated messages borrowed at once.
+  size_t max_in_use;
+  /// Number of borrows which found every preallocated message in use.
+  size_t exhausted_count;
+};
+
 /// Completely static memory allocation strategy for messages.
 /**
  * Templated on the type of message pooled by this class and the size of the message pool.
  * Templating allows the program to determine the memory required for this object at compile time.
  * The size of the message pool should be at least the largest number of concurrent accesses to
  * the subscription (usually the number of threads).
+ *
+ * Messages are borrowed from and returned to a lock-free free list, so the pool can be shared
+ * by the threads of a MultiThreadedExecutor.
+ * What happens once the pool is exhausted is set by the PoolExhaustedPolicy, and how often that
+ * happens is reported by get_statistics().
  */
 template<
   typename MessageT,
@@ -47,64 +84,178 @@ template<
 class MessagePoolMemoryStrategy
   : public message_memory_strategy::MessageMemoryStrategy<MessageT>
 {
+  static_assert(Size > 0, "the message pool cannot be empty");
+  static_assert(Size < UINT32_MAX, "the message pool is too large");
+
 public:
   RCLCPP_SMART_PTR_DEFINITIONS(MessagePoolMemoryStrategy)
 
   /// Default constructor
-  MessagePoolMemoryStrategy()
-  : next_array_index_(0)
+  /**
+   * \param[in] exhausted_policy what to do when borrowing while all messages are in use.
+   */
+  explicit MessagePoolMemoryStrategy(
+    PoolExhaustedPolicy exhausted_policy = PoolExhaustedPolicy::Throw)
+  : exhausted_policy_(exhausted_policy),
+    messages_(std::make_shared<std::array<MessageT, Size>>())
   {
     for (size_t i = 0; i < Size; ++i) {
-      pool_[i].msg_ptr_ = std::make_shared<MessageT>();
+      // The messages share the ownership of the array, so they outlive the pool if needed.
+      pool_[i].msg_ptr_ = std::shared_ptr<MessageT>(messages_, &(*messages_)[i]);
       pool_[i].used = false;
+      pool_[i].next_free = i + 1 < Size ? static_cast<uint32_t>(i + 2) : 0;
     }
+    free_head_ = 1;
   }
 
   /// Borrow a message from the message pool.
   /**
-   * Manage the message pool ring buffer.
-   * Throw an exception if the next message was not available.
+   * Take a free message from the pool, or apply the PoolExhaustedPolicy if there is none.
    * \return Shared pointer to the borrowed message.
+   * \throws std::runtime_error if the pool is exhausted and the policy is
+   *   PoolExhaustedPolicy::Throw.
    */
   std::shared_ptr<MessageT> borrow_message()
   {
-    size_t current_index = next_array_index_;
-    next_array_index_ = (next_array_index_ + 1) % Size;
-    if (pool_[current_index].used) {
-      throw std::runtime_error("Tried to access message that was still in use! Abort.");
+    size_t index;
+    if (pop_free_index(index)) {
+      pool_[index].used.store(true, std::memory_order_relaxed);
+      size_t in_use = in_use_.fetch_add(1, std::memory_order_relaxed) + 1;
+      size_t max_in_use = max_in_use_.load(std::memory_order_relaxed);
+      while (in_use > max_in_use &&
+        !max_in_use_.compare_exchange_weak(max_in_use, in_use, std::memory_order_relaxed))
+      {
+      }
+      return reset_message(pool_[index].msg_ptr_);
+    }
+    exhausted_count_.fetch_add(1, std::memory_order_relaxed);
+    switch (exhausted_policy_) {
+      case PoolExhaustedPolicy::Grow:
+        {
+          std::lock_guard<std::mutex> lock(grown_mutex_);
+          if (!grown_free_.empty()) {
+            std::shared_ptr<MessageT> msg = std::move(grown_free_.back());
+            grown_free_.pop_back();
+            return reset_message(msg);
+          }
+        }
+        return message_memory_strategy::MessageMemoryStrategy<MessageT>::borrow_message();
+      case PoolExhaustedPolicy::Allocate:
+        return message_memory_strategy::MessageMemoryStrategy<MessageT>::borrow_message();
+      case PoolExhaustedPolicy::Throw:
+      default:
+        throw std::runtime_error("Tried to borrow a message while all were in use! Abort.");
     }
-    pool_[current_index].msg_ptr_->~MessageT();
-    new (pool_[current_index].msg_ptr_.get())MessageT;
-
-    pool_[current_index].used = true;
-    return pool_[current_index].msg_ptr_;
   }
 
   /// Return a message to the message pool.
   /**
-   * Manage metadata in the message pool ring buffer to release the message.
+   * Put a preallocated message back in the free list, and handle the others according to the
+   * PoolExhaustedPolicy.
    * \param[in] msg Shared pointer to the message to return.
+   * \throws std::runtime_error if the message was already returned, or if it doesn't belong
+   *   to the pool and the policy is PoolExhaustedPolicy::Throw.
    */
   void return_message(std::shared_ptr<MessageT> & msg)
   {
-    for (size_t i = 0; i < Size; ++i) {
-      if (pool_[i].msg_ptr_ == msg) {
-        pool_[i].used = false;
-        return;
+    const MessageT * first = messages_->data();
+    std::less_equal<const MessageT *> less_equal;
+    if (less_equal(first, msg.get()) && less_equal(msg.get(), first + Size - 1)) {
+      size_t index = static_cast<size_t>(msg.get() - first);
+      if (!pool_[index].used.exchange(false, std::memory_order_relaxed)) {
+        throw std::runtime_error("Tried to return a message which was not borrowed.");
       }
+      in_use_.fetch_sub(1, std::memory_order_relaxed);
+      push_free_index(index);
+      return;
+    }
+    switch (exhausted_policy_) {
+      case PoolExhaustedPolicy::Grow:
+        {
+          std::lock_guard<std::mutex> lock(grown_mutex_);
+          grown_free_.push_back(msg);
+        }
+        return;
+      case PoolExhaustedPolicy::Allocate:
+        msg.reset();
+        return;
+      case PoolExhaustedPolicy::Throw:
+      default:
+        throw std::runtime_error("Unrecognized message ptr in return_message.");
     }
-    throw std::runtime_error("Unrecognized message ptr in return_message.");
+  }
+
+  /// Return the usage of the pool so far.
+  MessagePoolStatistics get_statistics() const
+  {
+    return {
+      Size,
+      in_use_.load(std::memory_order_relaxed),
+      max_in_use_.load(std::memory_order_relaxed),
+      exhausted_count_.load(std::memory_order_relaxed)};
   }
 
 protected:
   struct PoolMember
   {
     std::shared_ptr<MessageT> msg_ptr_;
-    bool used;
+    std::atomic_bool used;
+    /// One plus the index of the next free member, or 0 for none.
+    std::atomic<uint32_t> next_free;
   };
 
+  static std::shared_ptr<MessageT>
+  reset_message(const std::shared_ptr<MessageT> & msg)
+  {
+    msg->~MessageT();
+    new (msg.get())MessageT;
+    return msg;
+  }
+
+  /// Pop the first free member, the head being tagged with a counter against ABA.
+  bool pop_free_index(size_t & index)
+  {
+    uint64_t head = free_head_.load(std::memory_order_acquire);
+    while (true) {
+      uint32_t first = static_cast<uint32_t>(head);
+      if (0 == first) {
+        return false;
+      }
+      uint64_t next = pool_[first - 1].next_free.load(std::memory_order_relaxed);
+      uint64_t new_head = (((head >> 32) + 1) << 32) | next;
+      if (free_head_.compare_exchange_weak(
+          head, new_head, std::memory_order_acq_rel, std::memory_order_acquire))
+      {
+        index = first - 1;
+        return true;
+      }
+    }
+  }
+
+  void push_free_index(size_t index)
+  {
+    uint64_t head = free_head_.load(std::memory_order_relaxed);
+    uint64_t new_head;
+    do {
+      pool_[index].next_free.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+      new_head = (((head >> 32) + 1) << 32) | (index + 1);
+    } while (!free_head_.compare_exchange_weak(
+      head, new_head, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  const PoolExhaustedPolicy exhausted_policy_;
+  std::shared_ptr<std::array<MessageT, Size>> messages_;
   std::array<PoolMember, Size> pool_;
-  size_t next_array_index_;
+  /// Tag in the upper and one plus the index of the first free member in the lower 32 bits.
+  std::atomic<uint64_t> free_head_{0};
+
+  std::atomic_size_t in_use_{0};
+  std::atomic_size_t max_in_use_{0};
+  std::atomic_size_t exhausted_count_{0};
+
+  /// Messages allocated with PoolExhaustedPolicy::Grow, once returned.
+  std::mutex grown_mutex_;
+  std::vector<std::shared_ptr<MessageT>> grown_free_;
 };
 
 }  // namespace message_pool_memory_strategy
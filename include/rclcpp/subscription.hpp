@@ -219,6 +219,14 @@ public:
         static_cast<const void *>(get_subscription_handle().get()),
         static_cast<const void *>(subscription_intra_process_.get()));
 
+      // The middleware doesn't see intra-process messages, filter them before buffering.
+      const auto & content_filter_options = options_.content_filter_options;
+      if (!content_filter_options.filter_expression.empty()) {
+        this->set_intra_process_content_filter(
+          content_filter_options.filter_expression,
+          content_filter_options.expression_parameters);
+      }
+
       // Add it to the intra process manager.
       using rclcpp::experimental::IntraProcessManager;
       auto ipm = context->get_sub_context<IntraProcessManager>();
@@ -189,6 +189,51 @@ public:
   std::shared_ptr<rclcpp::SerializedMessage>
   create_serialized_message() = 0;
 
+  /// Borrow the message into which the executor takes inter-process data, reused across takes.
+  /**
+   * The message is created with create_message() on first use and then kept by the
+   * subscription, so that taking a message doesn't allocate in steady state.
+   * Only one borrower may hold it at a time, e.g. when a reentrant callback group lets several
+   * threads execute this subscription concurrently, the others get nullptr and should fall
+   * back to create_message().
+   *
+   * \return Shared pointer to the receive message, or nullptr if it is already borrowed.
+   */
+  RCLCPP_PUBLIC
+  std::shared_ptr<void>
+  borrow_receive_message();
+
+  /// Return the message borrowed with borrow_receive_message().
+  /**
+   * If the callback kept a reference to the message, it is given back with return_message()
+   * and a new one is created on the next borrow, so it is never overwritten while the user
+   * still holds it.
+   *
+   * \param[inout] message the borrowed message, which is reset.
+   */
+  RCLCPP_PUBLIC
+  void
+  return_receive_message(std::shared_ptr<void> & message);
+
+  /// Borrow the serialized message reused for taking inter-process data.
+  /**
+   * \sa borrow_receive_message()
+   * \return Shared pointer to the receive serialized message, or nullptr if it is already
+   *   borrowed.
+   */
+  RCLCPP_PUBLIC
+  std::shared_ptr<rclcpp::SerializedMessage>
+  borrow_receive_serialized_message();
+
+  /// Return the serialized message borrowed with borrow_receive_serialized_message().
+  /**
+   * \sa return_receive_message()
+   * \param[inout] message the borrowed serialized message, which is reset.
+   */
+  RCLCPP_PUBLIC
+  void
+  return_receive_serialized_message(std::shared_ptr<rclcpp::SerializedMessage> & message);
+
   /// Check if we need to handle the message, and execute the callback if we do.
   /**
    * \param[in] message Shared pointer to the message to handle.
@@ -512,6 +557,11 @@ public:
 
   /// Set the filter expression and expression parameters for the subscription.
   /**
+   * With intra-process communication, the filter is also applied to the messages
+   * published intra-process, once the middleware accepted it.
+   * If the middleware doesn't support content filtered topics, no exception is
+   * thrown and only the messages published intra-process are filtered.
+   *
    * \param[in] filter_expression A filter expression to set.
    *   \sa ContentFilterOptions::filter_expression
    *   An empty string ("") will clear the content filter setting of the subscription.
@@ -560,6 +610,18 @@ protected:
   bool
   matches_any_intra_process_publishers(const rmw_gid_t * sender_gid) const;
 
+  /// Apply a content filter to the messages received intra-process.
+  /**
+   * An empty filter expression removes the filter.
+   * If the expression can't be evaluated by rclcpp, a warning is logged and all the
+   * intra-process messages are received.
+   */
+  RCLCPP_PUBLIC
+  void
+  set_intra_process_content_filter(
+    const std::string & filter_expression,
+    const std::vector<std::string> & expression_parameters);
+
   RCLCPP_PUBLIC
   void
   set_on_new_message_callback(rcl_event_callback_t callback, const void * user_data);
@@ -586,6 +648,11 @@ private:
   rosidl_message_type_support_t type_support_;
   bool is_serialized_;
 
+  std::shared_ptr<void> receive_message_;
+  std::atomic<bool> receive_message_borrowed_{false};
+  std::shared_ptr<rclcpp::SerializedMessage> receive_serialized_message_;
+  std::atomic<bool> receive_serialized_message_borrowed_{false};
+
   std::atomic<bool> subscription_in_use_by_wait_set_{false};
   std::atomic<bool> intra_process_subscription_waitable_in_use_by_wait_set_{false};
 
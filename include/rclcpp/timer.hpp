@@ -153,11 +153,35 @@ public:
   bool
   exchange_in_use_by_wait_set_state(bool in_use_state);
 
+  /// Set by how much the callback may be delayed, to be executed along with other timers.
+  /**
+   * A timer with a slack may be called up to the slack after it is due, so that timers due
+   * around the same time are called in the same executor wake up.
+   * Timers are aligned on multiples of their slack, so timers with the same slack or with
+   * slacks that are multiples of each other are called together.
+   * A timer is never called before it is due: when its aligned deadline passes, its next call
+   * time is read again, so a timer reset or given another period meanwhile waits for its new
+   * deadline.
+   * This only applies to steady clock timers in an executor using the timer queue, see
+   * rclcpp::ExecutorOptions::use_timer_queue, and takes effect from the next call.
+   *
+   * \param[in] slack the tolerated delay, zero (the default) to call the timer when it is due.
+   */
+  RCLCPP_PUBLIC
+  void
+  set_slack(std::chrono::nanoseconds slack);
+
+  /// Return by how much the callback may be delayed to be executed along with other timers.
+  RCLCPP_PUBLIC
+  std::chrono::nanoseconds
+  get_slack() const;
+
 protected:
   Clock::SharedPtr clock_;
   std::shared_ptr<rcl_timer_t> timer_handle_;
 
   std::atomic<bool> in_use_by_wait_set_{false};
+  std::atomic<int64_t> slack_ns_{0};
 };
 
 
@@ -17,11 +17,19 @@
 
 #include <cassert>
 #include <functional>
+#include <memory>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "rcl/wait.h"
 
+#include "rclcpp/client.hpp"
+#include "rclcpp/guard_condition.hpp"
 #include "rclcpp/macros.hpp"
+#include "rclcpp/service.hpp"
+#include "rclcpp/subscription_base.hpp"
+#include "rclcpp/timer.hpp"
 #include "rclcpp/wait_result_kind.hpp"
 
 namespace rclcpp
@@ -35,7 +43,9 @@ namespace rclcpp
  *
  *   - provides the result of waiting, i.e. ready, timeout, or empty, and
  *   - holds the ownership of the entities of the wait set, if needed, and
- *   - provides the necessary information for iterating over the wait set.
+ *   - provides the necessary information for iterating over the wait set, and
+ *   - provides the indices of the ready entries of the rcl wait set, and
+ *   - provides the ready entities of the wait set.
  *
  * This class is only valid as long as the wait set which created it is valid,
  * and it must be deleted before the wait set is deleted, as it contains a
@@ -122,9 +132,94 @@ public:
     return *wait_set_pointer_;
   }
 
+  /// Indices of the entries of the rcl wait set which are ready, per kind of entity.
+  /**
+   * Each index refers to the array of the same name in the rcl wait set, e.g.
+   * `rcl_wait_set.subscriptions[ready_indices.subscriptions[0]]`, and the
+   * indices are in increasing order.
+   * For the guard conditions these include the ones added by the
+   * synchronization policy and by waitables, and waitables themselves are not
+   * listed, use rclcpp::Waitable::is_ready() for them.
+   */
+  struct ReadyIndices
+  {
+    std::vector<size_t> subscriptions;
+    std::vector<size_t> guard_conditions;
+    std::vector<size_t> timers;
+    std::vector<size_t> clients;
+    std::vector<size_t> services;
+    std::vector<size_t> events;
+  };
+
+  /// Return the indices of the ready entries of the rcl wait set.
+  /**
+   * These are collected once, on the first call, so iterating over them is
+   * proportional to the number of ready entities rather than the size of the
+   * wait set, and results which are never asked for them cost nothing.
+   *
+   * This is not thread-safe.
+   *
+   * \return the indices of the ready entries, by kind of entity.
+   * \throws std::runtime_error if the result was not ready
+   */
+  const ReadyIndices &
+  get_ready_indices() const
+  {
+    if (this->kind() != WaitResultKind::Ready) {
+      throw std::runtime_error("cannot access ready indices when the result was not ready");
+    }
+    if (!ready_indices_collected_) {
+      this->collect_ready_indices(wait_set_pointer_->get_rcl_wait_set());
+      ready_indices_collected_ = true;
+    }
+    return ready_indices_;
+  }
+
+  /// Entities of the wait set which are ready, per kind of entity.
+  /**
+   * The entities are in the order they were added to the wait set.
+   * Only the guard conditions added to the wait set are listed, not the ones
+   * added by the synchronization policy or by waitables, and waitables are
+   * not listed, use rclcpp::Waitable::is_ready() for them.
+   */
+  struct ReadyEntities
+  {
+    std::vector<std::shared_ptr<rclcpp::SubscriptionBase>> subscriptions;
+    std::vector<std::shared_ptr<rclcpp::GuardCondition>> guard_conditions;
+    std::vector<std::shared_ptr<rclcpp::TimerBase>> timers;
+    std::vector<std::shared_ptr<rclcpp::ClientBase>> clients;
+    std::vector<std::shared_ptr<rclcpp::ServiceBase>> services;
+  };
+
+  /// Return the ready entities of the wait set.
+  /**
+   * These are collected once, on the first call.
+   *
+   * This is not thread-safe.
+   *
+   * \return the ready entities, by kind of entity.
+   * \throws std::runtime_error if the result was not ready
+   */
+  const ReadyEntities &
+  get_ready_entities() const
+  {
+    if (this->kind() != WaitResultKind::Ready) {
+      throw std::runtime_error("cannot access ready entities when the result was not ready");
+    }
+    if (!ready_entities_collected_) {
+      wait_set_pointer_->collect_ready_entities(ready_entities_);
+      ready_entities_collected_ = true;
+    }
+    return ready_entities_;
+  }
+
   WaitResult(WaitResult && other) noexcept
   : wait_result_kind_(other.wait_result_kind_),
-    wait_set_pointer_(std::exchange(other.wait_set_pointer_, nullptr))
+    wait_set_pointer_(std::exchange(other.wait_set_pointer_, nullptr)),
+    ready_indices_collected_(other.ready_indices_collected_),
+    ready_indices_(std::move(other.ready_indices_)),
+    ready_entities_collected_(other.ready_entities_collected_),
+    ready_entities_(std::move(other.ready_entities_))
   {}
 
   ~WaitResult()
@@ -154,9 +249,36 @@ private:
     wait_set_pointer_->wait_result_acquire();
   }
 
+  void
+  collect_ready_indices(const rcl_wait_set_t & rcl_wait_set) const
+  {
+    auto collect = [](const auto * const * entries, size_t size, std::vector<size_t> & indices) {
+        for (size_t i = 0; i < size; ++i) {
+          if (entries[i]) {
+            indices.push_back(i);
+          }
+        }
+      };
+    collect(
+      rcl_wait_set.subscriptions, rcl_wait_set.size_of_subscriptions,
+      ready_indices_.subscriptions);
+    collect(
+      rcl_wait_set.guard_conditions, rcl_wait_set.size_of_guard_conditions,
+      ready_indices_.guard_conditions);
+    collect(rcl_wait_set.timers, rcl_wait_set.size_of_timers, ready_indices_.timers);
+    collect(rcl_wait_set.clients, rcl_wait_set.size_of_clients, ready_indices_.clients);
+    collect(rcl_wait_set.services, rcl_wait_set.size_of_services, ready_indices_.services);
+    collect(rcl_wait_set.events, rcl_wait_set.size_of_events, ready_indices_.events);
+  }
+
   const WaitResultKind wait_result_kind_;
 
   WaitSetT * wait_set_pointer_ = nullptr;
+
+  mutable bool ready_indices_collected_ = false;
+  mutable ReadyIndices ready_indices_;
+  mutable bool ready_entities_collected_ = false;
+  mutable ReadyEntities ready_entities_;
 };
 
 }  // namespace rclcpp
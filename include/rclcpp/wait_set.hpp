@@ -24,6 +24,7 @@
 #include "rclcpp/visibility_control.hpp"
 #include "rclcpp/wait_set_policies/dynamic_storage.hpp"
 #include "rclcpp/wait_set_policies/sequential_synchronization.hpp"
+#include "rclcpp/wait_set_policies/staged_synchronization.hpp"
 #include "rclcpp/wait_set_policies/static_storage.hpp"
 #include "rclcpp/wait_set_policies/thread_safe_synchronization.hpp"
 #include "rclcpp/wait_set_template.hpp"
@@ -101,6 +102,23 @@ using ThreadSafeWaitSet = rclcpp::WaitSetTemplate<
   rclcpp::wait_set_policies::DynamicStorage
 >;
 
+/// Like ThreadSafeWaitSet, but changes never block or interrupt a waiting thread.
+/**
+ * This wait set allows you to add and remove items dynamically from any
+ * thread, without locks, by staging the changes in a lock-free queue.
+ * The staged changes are applied by the thread calling wait(), the next time
+ * it calls it, so a change made during a wait() does not affect that wait.
+ *
+ * Only one thread may call wait() at a time.
+ *
+ * \sa rclcpp::wait_set_policies::StagedSynchronization
+ * \sa rclcpp::WaitSetTemplate for API documentation
+ */
+using StagedWaitSet = rclcpp::WaitSetTemplate<
+  rclcpp::wait_set_policies::StagedSynchronization,
+  rclcpp::wait_set_policies::DynamicStorage
+>;
+
 }  // namespace rclcpp
 
 #endif  // RCLCPP__WAIT_SET_HPP_
@@ -0,0 +1,133 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__WAIT_SET_POLICIES__DETAIL__STAGED_OPERATION_QUEUE_HPP_
+#define RCLCPP__WAIT_SET_POLICIES__DETAIL__STAGED_OPERATION_QUEUE_HPP_
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace rclcpp
+{
+namespace wait_set_policies
+{
+namespace detail
+{
+
+/// Lock-free multi-producer, single-consumer queue of deferred operations.
+/**
+ * Any number of threads may push() concurrently, without blocking each other.
+ * Only one thread at a time may call apply_all(), which runs every operation
+ * pushed so far in the order in which they were pushed.
+ *
+ * Internally this is an intrusive stack which the consumer takes as a whole
+ * with a single exchange, so it is not subject to the ABA problem.
+ */
+class StagedOperationQueue
+{
+public:
+  StagedOperationQueue() = default;
+
+  StagedOperationQueue(const StagedOperationQueue &) = delete;
+  StagedOperationQueue & operator=(const StagedOperationQueue &) = delete;
+
+  ~StagedOperationQueue()
+  {
+    delete_nodes(head_.exchange(nullptr, std::memory_order_acquire));
+  }
+
+  /// Stage an operation, to be run by the next call to apply_all().
+  void
+  push(std::function<void()> && operation)
+  {
+    Node * node = new Node{std::move(operation), head_.load(std::memory_order_relaxed)};
+    while (!head_.compare_exchange_weak(
+        node->next, node, std::memory_order_release, std::memory_order_relaxed))
+    {
+      // node->next was updated with the current head, try again.
+    }
+  }
+
+  /// Return true if operations are staged, which may be stale by the time it returns.
+  bool
+  empty() const
+  {
+    return nullptr == head_.load(std::memory_order_acquire);
+  }
+
+  /// Run and discard all staged operations, in the order they were pushed.
+  /**
+   * If an operation throws, the remaining operations are still run and the
+   * first exception is rethrown afterwards.
+   */
+  void
+  apply_all()
+  {
+    Node * stack = head_.exchange(nullptr, std::memory_order_acquire);
+    if (nullptr == stack) {
+      return;
+    }
+    // Reverse the stack, so the operations are applied in push order.
+    Node * fifo = nullptr;
+    while (nullptr != stack) {
+      Node * next = stack->next;
+      stack->next = fifo;
+      fifo = stack;
+      stack = next;
+    }
+    std::exception_ptr first_exception;
+    while (nullptr != fifo) {
+      std::unique_ptr<Node> node(fifo);
+      fifo = node->next;
+      try {
+        node->operation();
+      } catch (...) {
+        if (!first_exception) {
+          first_exception = std::current_exception();
+        }
+      }
+    }
+    if (first_exception) {
+      std::rethrow_exception(first_exception);
+    }
+  }
+
+private:
+  struct Node
+  {
+    std::function<void()> operation;
+    Node * next;
+  };
+
+  static void
+  delete_nodes(Node * node)
+  {
+    while (nullptr != node) {
+      Node * next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  std::atomic<Node *> head_{nullptr};
+};
+
+}  // namespace detail
+}  // namespace wait_set_policies
+}  // namespace rclcpp
+
+#endif  // RCLCPP__WAIT_SET_POLICIES__DETAIL__STAGED_OPERATION_QUEUE_HPP_
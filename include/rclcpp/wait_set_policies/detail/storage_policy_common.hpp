@@ -15,9 +15,12 @@
 #ifndef RCLCPP__WAIT_SET_POLICIES__DETAIL__STORAGE_POLICY_COMMON_HPP_
 #define RCLCPP__WAIT_SET_POLICIES__DETAIL__STORAGE_POLICY_COMMON_HPP_
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include "rcl/wait.h"
 
@@ -154,6 +157,12 @@ protected:
    *   - resizing the wait set if needed,
    *   - clearing the wait set if not already done by resizing, and
    *   - re-adding the entities.
+   *
+   * rcl_wait() removes the entities which are not ready from the wait set, and rcl provides
+   * no way to restore them, so they have to be re-added before each wait.
+   * With strong ownership the entities can't go away, so as long as the wait set isn't resized
+   * their rcl handles are re-added from a cache filled by the previous full rebuild, without
+   * locking or copying any shared pointer.
    */
   template<
     class SubscriptionsIterable,
@@ -175,6 +184,19 @@ protected:
     const WaitablesIterable & waitables
   )
   {
+    if (HasStrongOwnership && rcl_handles_cached_ && !needs_resize_) {
+      this->storage_rebuild_rcl_wait_set_from_cache(extra_guard_conditions, waitables);
+      return;
+    }
+    const bool cache_rcl_handles = HasStrongOwnership;
+    if (cache_rcl_handles) {
+      cached_subscription_handles_.clear();
+      cached_guard_condition_handles_.clear();
+      cached_timer_handles_.clear();
+      cached_client_handles_.clear();
+      cached_service_handles_.clear();
+    }
+
     bool was_resized = false;
     // Resize the wait set, but only if it needs to be.
     if (needs_resize_) {
@@ -257,13 +279,17 @@ protected:
         needs_pruning_ = true;
         continue;
       }
+      auto subscription_handle = subscription_ptr_pair.second->get_subscription_handle();
       rcl_ret_t ret = rcl_wait_set_add_subscription(
         &rcl_wait_set_,
-        subscription_ptr_pair.second->get_subscription_handle().get(),
+        subscription_handle.get(),
         nullptr);
       if (RCL_RET_OK != ret) {
         rclcpp::exceptions::throw_from_rcl_error(ret);
       }
+      if (cache_rcl_handles) {
+        cached_subscription_handles_.push_back(subscription_handle.get());
+      }
     }
 
     // Setup common code to add guard_conditions.
@@ -295,6 +321,12 @@ protected:
 
     // Add guard conditions.
     add_guard_conditions(guard_conditions);
+    if (cache_rcl_handles) {
+      for (const auto & guard_condition : guard_conditions) {
+        cached_guard_condition_handles_.push_back(
+          &get_raw_pointer_from_smart_pointer(guard_condition).second->get_rcl_guard_condition());
+      }
+    }
 
     // Add extra guard conditions.
     add_guard_conditions(extra_guard_conditions);
@@ -313,13 +345,17 @@ protected:
         needs_pruning_ = true;
         continue;
       }
+      auto timer_handle = timer_ptr_pair.second->get_timer_handle();
       rcl_ret_t ret = rcl_wait_set_add_timer(
         &rcl_wait_set_,
-        timer_ptr_pair.second->get_timer_handle().get(),
+        timer_handle.get(),
         nullptr);
       if (RCL_RET_OK != ret) {
         rclcpp::exceptions::throw_from_rcl_error(ret);
       }
+      if (cache_rcl_handles) {
+        cached_timer_handles_.push_back(timer_handle.get());
+      }
     }
 
     // Add clients.
@@ -336,13 +372,17 @@ protected:
         needs_pruning_ = true;
         continue;
       }
+      auto client_handle = client_ptr_pair.second->get_client_handle();
       rcl_ret_t ret = rcl_wait_set_add_client(
         &rcl_wait_set_,
-        client_ptr_pair.second->get_client_handle().get(),
+        client_handle.get(),
         nullptr);
       if (RCL_RET_OK != ret) {
         rclcpp::exceptions::throw_from_rcl_error(ret);
       }
+      if (cache_rcl_handles) {
+        cached_client_handles_.push_back(client_handle.get());
+      }
     }
 
     // Add services.
@@ -359,13 +399,17 @@ protected:
         needs_pruning_ = true;
         continue;
       }
+      auto service_handle = service_ptr_pair.second->get_service_handle();
       rcl_ret_t ret = rcl_wait_set_add_service(
         &rcl_wait_set_,
-        service_ptr_pair.second->get_service_handle().get(),
+        service_handle.get(),
         nullptr);
       if (RCL_RET_OK != ret) {
         rclcpp::exceptions::throw_from_rcl_error(ret);
       }
+      if (cache_rcl_handles) {
+        cached_service_handles_.push_back(service_handle.get());
+      }
     }
 
     // Add waitables.
@@ -385,6 +429,174 @@ protected:
       rclcpp::Waitable & waitable = *waitable_ptr_pair.second;
       waitable.add_to_wait_set(&rcl_wait_set_);
     }
+
+    rcl_handles_cached_ = cache_rcl_handles;
+  }
+
+  /// Clear the wait set and re-add the rcl handles cached by the last full rebuild.
+  template<class ExtraGuardConditionsIterable, class WaitablesIterable>
+  void
+  storage_rebuild_rcl_wait_set_from_cache(
+    const ExtraGuardConditionsIterable & extra_guard_conditions,
+    const WaitablesIterable & waitables)
+  {
+    rcl_ret_t ret = rcl_wait_set_clear(&rcl_wait_set_);
+    if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret);
+    }
+    for (const rcl_subscription_t * subscription : cached_subscription_handles_) {
+      ret = rcl_wait_set_add_subscription(&rcl_wait_set_, subscription, nullptr);
+      if (RCL_RET_OK != ret) {
+        rclcpp::exceptions::throw_from_rcl_error(ret);
+      }
+    }
+    for (const rcl_guard_condition_t * guard_condition : cached_guard_condition_handles_) {
+      ret = rcl_wait_set_add_guard_condition(&rcl_wait_set_, guard_condition, nullptr);
+      if (RCL_RET_OK != ret) {
+        rclcpp::exceptions::throw_from_rcl_error(ret);
+      }
+    }
+    // Extra guard conditions come from the synchronization policy with each call.
+    for (const auto & guard_condition : extra_guard_conditions) {
+      ret = rcl_wait_set_add_guard_condition(
+        &rcl_wait_set_,
+        &get_raw_pointer_from_smart_pointer(guard_condition).second->get_rcl_guard_condition(),
+        nullptr);
+      if (RCL_RET_OK != ret) {
+        rclcpp::exceptions::throw_from_rcl_error(ret);
+      }
+    }
+    for (const rcl_timer_t * timer : cached_timer_handles_) {
+      ret = rcl_wait_set_add_timer(&rcl_wait_set_, timer, nullptr);
+      if (RCL_RET_OK != ret) {
+        rclcpp::exceptions::throw_from_rcl_error(ret);
+      }
+    }
+    for (const rcl_client_t * client : cached_client_handles_) {
+      ret = rcl_wait_set_add_client(&rcl_wait_set_, client, nullptr);
+      if (RCL_RET_OK != ret) {
+        rclcpp::exceptions::throw_from_rcl_error(ret);
+      }
+    }
+    for (const rcl_service_t * service : cached_service_handles_) {
+      ret = rcl_wait_set_add_service(&rcl_wait_set_, service, nullptr);
+      if (RCL_RET_OK != ret) {
+        rclcpp::exceptions::throw_from_rcl_error(ret);
+      }
+    }
+    // Waitables decide what they add, so they can't be cached.
+    for (const auto & waitable_entry : waitables) {
+      get_raw_pointer_from_smart_pointer(waitable_entry.waitable).second->add_to_wait_set(
+        &rcl_wait_set_);
+    }
+  }
+
+  /// Collect the entities whose rcl handles were left in the wait set by rcl_wait().
+  /**
+   * The entities are matched by their rcl handles, as the entries of the rcl
+   * wait set only line up with the sequences of entities when none of them
+   * was deleted since the wait set was rebuilt.
+   */
+  template<
+    class SubscriptionsIterable,
+    class GuardConditionsIterable,
+    class TimersIterable,
+    class ClientsIterable,
+    class ServicesIterable,
+    class ReadyEntitiesT
+  >
+  void
+  storage_collect_ready_entities_with_sets(
+    const SubscriptionsIterable & subscriptions,
+    const GuardConditionsIterable & guard_conditions,
+    const TimersIterable & timers,
+    const ClientsIterable & clients,
+    const ServicesIterable & services,
+    ReadyEntitiesT & ready_entities
+  )
+  {
+    auto same_entity = [](const auto & entity) -> const auto & {return entity;};
+    this->storage_collect_ready_entities_of_kind(
+      rcl_wait_set_.subscriptions, rcl_wait_set_.size_of_subscriptions,
+      subscriptions,
+      [](const auto & subscription_entry) -> const auto & {return subscription_entry.subscription;},
+      [](rclcpp::SubscriptionBase & subscription) {
+        return subscription.get_subscription_handle().get();
+      },
+      ready_entities.subscriptions);
+    this->storage_collect_ready_entities_of_kind(
+      rcl_wait_set_.guard_conditions, rcl_wait_set_.size_of_guard_conditions,
+      guard_conditions, same_entity,
+      [](rclcpp::GuardCondition & guard_condition) {
+        return &guard_condition.get_rcl_guard_condition();
+      },
+      ready_entities.guard_conditions);
+    this->storage_collect_ready_entities_of_kind(
+      rcl_wait_set_.timers, rcl_wait_set_.size_of_timers,
+      timers, same_entity,
+      [](rclcpp::TimerBase & timer) {return timer.get_timer_handle().get();},
+      ready_entities.timers);
+    this->storage_collect_ready_entities_of_kind(
+      rcl_wait_set_.clients, rcl_wait_set_.size_of_clients,
+      clients, same_entity,
+      [](rclcpp::ClientBase & client) {return client.get_client_handle().get();},
+      ready_entities.clients);
+    this->storage_collect_ready_entities_of_kind(
+      rcl_wait_set_.services, rcl_wait_set_.size_of_services,
+      services, same_entity,
+      [](rclcpp::ServiceBase & service) {return service.get_service_handle().get();},
+      ready_entities.services);
+  }
+
+  template<
+    class RclEntityT,
+    class EntitiesIterable,
+    class GetEntityT,
+    class GetRclHandleT,
+    class EntityT
+  >
+  void
+  storage_collect_ready_entities_of_kind(
+    const RclEntityT * const * rcl_entities,
+    size_t size_of_rcl_entities,
+    const EntitiesIterable & entities,
+    GetEntityT get_entity,
+    GetRclHandleT get_rcl_handle,
+    std::vector<std::shared_ptr<EntityT>> & ready_entities)
+  {
+    std::vector<const RclEntityT *> ready_rcl_entities;
+    for (size_t i = 0; i < size_of_rcl_entities; ++i) {
+      if (rcl_entities[i]) {
+        ready_rcl_entities.push_back(rcl_entities[i]);
+      }
+    }
+    if (ready_rcl_entities.empty()) {
+      return;
+    }
+    std::sort(ready_rcl_entities.begin(), ready_rcl_entities.end(), std::less<>());
+    for (const auto & entry : entities) {
+      std::shared_ptr<EntityT> entity = get_shared_pointer(get_entity(entry));
+      if (entity && std::binary_search(
+          ready_rcl_entities.begin(), ready_rcl_entities.end(),
+          get_rcl_handle(*entity), std::less<>()))
+      {
+        ready_entities.push_back(std::move(entity));
+      }
+    }
+  }
+
+  template<class EntityT>
+  std::shared_ptr<EntityT>
+  get_shared_pointer(const std::shared_ptr<EntityT> & shared_pointer)
+  {
+    return shared_pointer;
+  }
+
+  template<class EntityT>
+  std::shared_ptr<EntityT>
+  get_shared_pointer(const std::weak_ptr<EntityT> & weak_pointer)
+  {
+    return weak_pointer.lock();
   }
 
   const rcl_wait_set_t &
@@ -410,6 +622,14 @@ protected:
 
   bool needs_pruning_ = false;
   bool needs_resize_ = false;
+
+  // rcl handles of the entities as of the last full rebuild, only used with strong ownership.
+  bool rcl_handles_cached_ = false;
+  std::vector<const rcl_subscription_t *> cached_subscription_handles_;
+  std::vector<const rcl_guard_condition_t *> cached_guard_condition_handles_;
+  std::vector<const rcl_timer_t *> cached_timer_handles_;
+  std::vector<const rcl_client_t *> cached_client_handles_;
+  std::vector<const rcl_service_t *> cached_service_handles_;
 };
 
 }  // namespace detail
@@ -32,6 +32,15 @@ protected:
   SynchronizationPolicyCommon() = default;
   ~SynchronizationPolicyCommon() = default;
 
+  /// Apply changes deferred by the policy, called by wait() before taking ownership of entities.
+  /**
+   * Policies which apply changes immediately have nothing to do here.
+   */
+  void
+  sync_apply_deferred_changes()
+  {
+  }
+
   std::function<bool()>
   create_loop_predicate(
     std::chrono::nanoseconds time_to_wait_ns,
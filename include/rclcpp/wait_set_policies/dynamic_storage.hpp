@@ -391,6 +391,20 @@ public:
     waitables_.erase(std::remove_if(waitables_.begin(), waitables_.end(), p), waitables_.end());
   }
 
+  template<class ReadyEntitiesT>
+  void
+  storage_collect_ready_entities(ReadyEntitiesT & ready_entities)
+  {
+    this->storage_collect_ready_entities_with_sets(
+      subscriptions_,
+      guard_conditions_,
+      timers_,
+      clients_,
+      services_,
+      ready_entities
+    );
+  }
+
   void
   storage_acquire_ownerships()
   {
@@ -0,0 +1,349 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__WAIT_SET_POLICIES__STAGED_SYNCHRONIZATION_HPP_
+#define RCLCPP__WAIT_SET_POLICIES__STAGED_SYNCHRONIZATION_HPP_
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "rclcpp/client.hpp"
+#include "rclcpp/exceptions.hpp"
+#include "rclcpp/guard_condition.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/service.hpp"
+#include "rclcpp/subscription_base.hpp"
+#include "rclcpp/subscription_wait_set_mask.hpp"
+#include "rclcpp/timer.hpp"
+#include "rclcpp/visibility_control.hpp"
+#include "rclcpp/wait_result.hpp"
+#include "rclcpp/wait_result_kind.hpp"
+#include "rclcpp/wait_set_policies/detail/staged_operation_queue.hpp"
+#include "rclcpp/wait_set_policies/detail/synchronization_policy_common.hpp"
+#include "rclcpp/waitable.hpp"
+
+namespace rclcpp
+{
+namespace wait_set_policies
+{
+
+/// WaitSet policy that stages changes from any thread and applies them in wait().
+/**
+ * Adding and removing entities, as well as pruning deleted entities, never
+ * blocks and never interrupts a thread that is currently waiting.
+ * Instead each change is pushed onto a lock-free queue, and the thread calling
+ * wait() applies all staged changes, in the order they were made, on entry to
+ * wait().
+ *
+ * As a consequence, a change made while another thread is waiting only takes
+ * effect once that thread wakes up and calls wait() again, and errors from a
+ * staged change, e.g. adding an entity twice, are thrown from wait() rather
+ * than from the add or remove function.
+ * Changes staged while a WaitResult is alive are held back until it is destroyed.
+ *
+ * Only one thread may call wait() and use the resulting WaitResult at a time.
+ */
+class StagedSynchronization : public detail::SynchronizationPolicyCommon
+{
+protected:
+  explicit StagedSynchronization(rclcpp::Context::SharedPtr) {}
+  ~StagedSynchronization() = default;
+
+  /// Return any "extra" guard conditions needed to implement the synchronization policy.
+  /**
+   * Since this policy never interrupts the waiting thread, it needs no extra
+   * guard conditions to implement it.
+   */
+  const std::array<std::shared_ptr<rclcpp::GuardCondition>, 0> &
+  get_extra_guard_conditions()
+  {
+    static const std::array<std::shared_ptr<rclcpp::GuardCondition>, 0> empty{};
+    return empty;
+  }
+
+  /// Stage adding a subscription, which is applied by the next wait().
+  /**
+   * Does not throw, except for std::bad_alloc.
+   */
+  void
+  sync_add_subscription(
+    std::shared_ptr<rclcpp::SubscriptionBase> && subscription,
+    const rclcpp::SubscriptionWaitSetMask & mask,
+    std::function<
+      void(std::shared_ptr<rclcpp::SubscriptionBase>&&, const rclcpp::SubscriptionWaitSetMask &)
+    > add_subscription_function)
+  {
+    staged_operations_.push(
+      [subscription = std::move(subscription), mask,
+      add_subscription_function = std::move(add_subscription_function)]() mutable {
+        add_subscription_function(std::move(subscription), mask);
+      });
+  }
+
+  /// Stage removing a subscription, which is applied by the next wait().
+  /**
+   * Does not throw, except for std::bad_alloc.
+   */
+  void
+  sync_remove_subscription(
+    std::shared_ptr<rclcpp::SubscriptionBase> && subscription,
+    const rclcpp::SubscriptionWaitSetMask & mask,
+    std::function<
+      void(std::shared_ptr<rclcpp::SubscriptionBase>&&, const rclcpp::SubscriptionWaitSetMask &)
+    > remove_subscription_function)
+  {
+    staged_operations_.push(
+      [subscription = std::move(subscription), mask,
+      remove_subscription_function = std::move(remove_subscription_function)]() mutable {
+        remove_subscription_function(std::move(subscription), mask);
+      });
+  }
+
+  /// Stage adding a guard condition, which is applied by the next wait().
+  /**
+   * Does not throw, except for std::bad_alloc.
+   */
+  void
+  sync_add_guard_condition(
+    std::shared_ptr<rclcpp::GuardCondition> && guard_condition,
+    std::function<void(std::shared_ptr<rclcpp::GuardCondition>&&)> add_guard_condition_function)
+  {
+    this->stage(std::move(guard_condition), std::move(add_guard_condition_function));
+  }
+
+  /// Stage removing a guard condition, which is applied by the next wait().
+  /**
+   * Does not throw, except for std::bad_alloc.
+   */
+  void
+  sync_remove_guard_condition(
+    std::shared_ptr<rclcpp::GuardCondition> && guard_condition,
+    std::function<void(std::shared_ptr<rclcpp::GuardCondition>&&)> remove_guard_condition_function)
+  {
+    this->stage(std::move(guard_condition), std::move(remove_guard_condition_function));
+  }
+
+  /// Stage adding a timer, which is applied by the next wait().
+  /**
+   * Does not throw, except for std::bad_alloc.
+   */
+  void
+  sync_add_timer(
+    std::shared_ptr<rclcpp::TimerBase> && timer,
+    std::function<void(std::shared_ptr<rclcpp::TimerBase>&&)> add_timer_function)
+  {
+    this->stage(std::move(timer), std::move(add_timer_function));
+  }
+
+  /// Stage removing a timer, which is applied by the next wait().
+  /**
+   * Does not throw, except for std::bad_alloc.
+   */
+  void
+  sync_remove_timer(
+    std::shared_ptr<rclcpp::TimerBase> && timer,
+    std::function<void(std::shared_ptr<rclcpp::TimerBase>&&)> remove_timer_function)
+  {
+    this->stage(std::move(timer), std::move(remove_timer_function));
+  }
+
+  /// Stage adding a client, which is applied by the next wait().
+  /**
+   * Does not throw, except for std::bad_alloc.
+   */
+  void
+  sync_add_client(
+    std::shared_ptr<rclcpp::ClientBase> && client,
+    std::function<void(std::shared_ptr<rclcpp::ClientBase>&&)> add_client_function)
+  {
+    this->stage(std::move(client), std::move(add_client_function));
+  }
+
+  /// Stage removing a client, which is applied by the next wait().
+  /**
+   * Does not throw, except for std::bad_alloc.
+   */
+  void
+  sync_remove_client(
+    std::shared_ptr<rclcpp::ClientBase> && client,
+    std::function<void(std::shared_ptr<rclcpp::ClientBase>&&)> remove_client_function)
+  {
+    this->stage(std::move(client), std::move(remove_client_function));
+  }
+
+  /// Stage adding a service, which is applied by the next wait().
+  /**
+   * Does not throw, except for std::bad_alloc.
+   */
+  void
+  sync_add_service(
+    std::shared_ptr<rclcpp::ServiceBase> && service,
+    std::function<void(std::shared_ptr<rclcpp::ServiceBase>&&)> add_service_function)
+  {
+    this->stage(std::move(service), std::move(add_service_function));
+  }
+
+  /// Stage removing a service, which is applied by the next wait().
+  /**
+   * Does not throw, except for std::bad_alloc.
+   */
+  void
+  sync_remove_service(
+    std::shared_ptr<rclcpp::ServiceBase> && service,
+    std::function<void(std::shared_ptr<rclcpp::ServiceBase>&&)> remove_service_function)
+  {
+    this->stage(std::move(service), std::move(remove_service_function));
+  }
+
+  /// Stage adding a waitable, which is applied by the next wait().
+  /**
+   * Does not throw, except for std::bad_alloc.
+   */
+  void
+  sync_add_waitable(
+    std::shared_ptr<rclcpp::Waitable> && waitable,
+    std::shared_ptr<void> && associated_entity,
+    std::function<
+      void(std::shared_ptr<rclcpp::Waitable>&&, std::shared_ptr<void> &&)
+    > add_waitable_function)
+  {
+    staged_operations_.push(
+      [waitable = std::move(waitable), associated_entity = std::move(associated_entity),
+      add_waitable_function = std::move(add_waitable_function)]() mutable {
+        add_waitable_function(std::move(waitable), std::move(associated_entity));
+      });
+  }
+
+  /// Stage removing a waitable, which is applied by the next wait().
+  /**
+   * Does not throw, except for std::bad_alloc.
+   */
+  void
+  sync_remove_waitable(
+    std::shared_ptr<rclcpp::Waitable> && waitable,
+    std::function<void(std::shared_ptr<rclcpp::Waitable>&&)> remove_waitable_function)
+  {
+    this->stage(std::move(waitable), std::move(remove_waitable_function));
+  }
+
+  /// Stage pruning deleted entities, which is applied by the next wait().
+  /**
+   * Does not throw, except for std::bad_alloc.
+   */
+  void
+  sync_prune_deleted_entities(std::function<void()> prune_deleted_entities_function)
+  {
+    staged_operations_.push(std::move(prune_deleted_entities_function));
+  }
+
+  /// Apply the changes staged since the last call, in the order they were staged.
+  /**
+   * Only the thread calling wait() does this, so the storage needs no lock.
+   *
+   * \throws the first exception thrown by a staged change, after applying the others.
+   */
+  void
+  sync_apply_deferred_changes()
+  {
+    staged_operations_.apply_all();
+  }
+
+  /// Implements wait without interrupting it for staged changes.
+  template<class WaitResultT>
+  WaitResultT
+  sync_wait(
+    std::chrono::nanoseconds time_to_wait_ns,
+    std::function<void()> rebuild_rcl_wait_set,
+    std::function<rcl_wait_set_t & ()> get_rcl_wait_set,
+    std::function<WaitResultT(WaitResultKind wait_result_kind)> create_wait_result)
+  {
+    // Assumption: this function assumes that some measure has been taken to
+    // ensure none of the entities being waited on by the wait set are allowed
+    // to go out of scope and therefore be deleted.
+    // See SequentialSynchronization::sync_wait() for details.
+    // Staged changes were applied by wait() before taking that ownership, and
+    // are not applied here so the owned entities match the stored ones.
+
+    // Setup looping predicate.
+    auto start = std::chrono::steady_clock::now();
+    std::function<bool()> should_loop = this->create_loop_predicate(time_to_wait_ns, start);
+
+    // Wait until exit condition is met.
+    do {
+      // Rebuild the wait set, which resizes it if the staged changes require it.
+      rebuild_rcl_wait_set();
+
+      rcl_wait_set_t & rcl_wait_set = get_rcl_wait_set();
+
+      // Calculate how much time there is left to wait, unless blocking indefinitely.
+      auto time_left_to_wait_ns = this->calculate_time_left_to_wait(time_to_wait_ns, start);
+
+      // Then wait for entities to become ready.
+      // Changes staged during this wait do not interrupt it.
+      rcl_ret_t ret = rcl_wait(&rcl_wait_set, time_left_to_wait_ns.count());
+      if (RCL_RET_OK == ret) {
+        // Something has become ready in the wait set, and since this class
+        // did not add anything to it, it is a user entity that is ready.
+        return create_wait_result(WaitResultKind::Ready);
+      } else if (RCL_RET_TIMEOUT == ret) {
+        // The wait set timed out, exit the loop.
+        break;
+      } else if (RCL_RET_WAIT_SET_EMPTY == ret) {
+        // Wait set was empty, return Empty.
+        return create_wait_result(WaitResultKind::Empty);
+      } else {
+        // Some other error case, throw.
+        rclcpp::exceptions::throw_from_rcl_error(ret);
+      }
+    } while (should_loop());
+
+    // Wait did not result in ready items, return timeout.
+    return create_wait_result(WaitResultKind::Timeout);
+  }
+
+  void
+  sync_wait_result_acquire()
+  {
+    // Explicitly do nothing, the storage is only changed by the waiting thread.
+  }
+
+  void
+  sync_wait_result_release()
+  {
+    // Explicitly do nothing, the storage is only changed by the waiting thread.
+  }
+
+private:
+  template<typename EntityT>
+  void
+  stage(
+    std::shared_ptr<EntityT> && entity,
+    std::function<void(std::shared_ptr<EntityT>&&)> && function)
+  {
+    staged_operations_.push(
+      [entity = std::move(entity), function = std::move(function)]() mutable {
+        function(std::move(entity));
+      });
+  }
+
+  detail::StagedOperationQueue staged_operations_;
+};
+
+}  // namespace wait_set_policies
+}  // namespace rclcpp
+
+#endif  // RCLCPP__WAIT_SET_POLICIES__STAGED_SYNCHRONIZATION_HPP_
@@ -176,6 +176,20 @@ public:
   // storage_remove_waitable() explicitly not declared here
   // storage_prune_deleted_entities() explicitly not declared here
 
+  template<class ReadyEntitiesT>
+  void
+  storage_collect_ready_entities(ReadyEntitiesT & ready_entities)
+  {
+    this->storage_collect_ready_entities_with_sets(
+      subscriptions_,
+      guard_conditions_,
+      timers_,
+      clients_,
+      services_,
+      ready_entities
+    );
+  }
+
   void
   storage_acquire_ownerships()
   {
@@ -657,6 +657,12 @@ public:
   {
     auto time_to_wait_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time_to_wait);
 
+    // apply changes deferred by the SynchronizationPolicy, unless a WaitResult still uses the
+    // entities, in which case they are applied by the next wait()
+    if (!wait_result_holding_) {
+      this->sync_apply_deferred_changes();
+    }
+
     // ensure the ownership of the entities in the wait set is shared for the duration of wait
     this->storage_acquire_ownerships();
     RCPPUTILS_SCOPE_EXIT({this->storage_release_ownerships();});
@@ -721,6 +727,15 @@ private:
     this->storage_acquire_ownerships();
   }
 
+  /// Called by the WaitResult to collect the ready entities.
+  template<class ReadyEntitiesT>
+  void
+  collect_ready_entities(ReadyEntitiesT & ready_entities)
+  {
+    // this method comes from the StoragePolicy
+    this->storage_collect_ready_entities(ready_entities);
+  }
+
   /// Called by the WaitResult's destructor to release resources.
   /**
    * Should only be called if wait_result_acquire() has been called.
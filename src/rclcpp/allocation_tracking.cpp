@@ -0,0 +1,209 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// This is built into its own library, since it replaces the allocation functions of the process.
+
+#include "rclcpp/allocation_tracking.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+extern "C"
+{
+void * __libc_malloc(size_t size);
+void * __libc_calloc(size_t number, size_t size);
+void * __libc_realloc(void * pointer, size_t size);
+void * __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void * pointer);
+}
+#endif
+
+namespace
+{
+
+// Constant initialized, so it doesn't allocate when a thread first counts.
+thread_local rclcpp::allocation_tracking::AllocationCounts thread_counts;
+
+void
+count_allocation(size_t size)
+{
+  ++thread_counts.allocations;
+  thread_counts.bytes_allocated += size;
+}
+
+void
+count_deallocation(void * pointer)
+{
+  if (pointer) {
+    ++thread_counts.deallocations;
+  }
+}
+
+// Allocate without counting, as both operator new and malloc() count.
+void *
+raw_allocate(size_t size, size_t alignment)
+{
+#if defined(__GLIBC__)
+  return alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ?
+         __libc_memalign(alignment, size) : __libc_malloc(size);
+#else
+  if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+  }
+  return std::malloc(size);
+#endif
+}
+
+void
+raw_free(void * pointer)
+{
+#if defined(__GLIBC__)
+  __libc_free(pointer);
+#else
+  std::free(pointer);
+#endif
+}
+
+void *
+tracked_new(size_t size, size_t alignment)
+{
+  count_allocation(size);
+  void * pointer = raw_allocate(size ? size : 1, alignment);
+  if (!pointer) {
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+
+}  // namespace
+
+rclcpp::allocation_tracking::AllocationCounts
+rclcpp::allocation_tracking::get_thread_allocation_counts()
+{
+  return thread_counts;
+}
+
+// The other forms of operator new and delete call these by default.
+void *
+operator new(size_t size)
+{
+  return tracked_new(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *
+operator new(size_t size, std::align_val_t alignment)
+{
+  return tracked_new(size, static_cast<size_t>(alignment));
+}
+
+void
+operator delete(void * pointer) noexcept
+{
+  count_deallocation(pointer);
+  raw_free(pointer);
+}
+
+void
+operator delete(void * pointer, std::align_val_t) noexcept
+{
+  count_deallocation(pointer);
+  raw_free(pointer);
+}
+
+void
+operator delete(void * pointer, size_t) noexcept
+{
+  count_deallocation(pointer);
+  raw_free(pointer);
+}
+
+void
+operator delete(void * pointer, size_t, std::align_val_t) noexcept
+{
+  count_deallocation(pointer);
+  raw_free(pointer);
+}
+
+#if defined(__GLIBC__)
+extern "C"
+{
+
+void *
+malloc(size_t size)
+{
+  count_allocation(size);
+  return __libc_malloc(size);
+}
+
+void *
+calloc(size_t number, size_t size)
+{
+  count_allocation(number * size);
+  return __libc_calloc(number, size);
+}
+
+void *
+realloc(void * pointer, size_t size)
+{
+  count_deallocation(pointer);
+  count_allocation(size);
+  return __libc_realloc(pointer, size);
+}
+
+void *
+memalign(size_t alignment, size_t size)
+{
+  count_allocation(size);
+  return __libc_memalign(alignment, size);
+}
+
+void *
+aligned_alloc(size_t alignment, size_t size)
+{
+  if (0u == alignment || 0u != (alignment & (alignment - 1u))) {
+    errno = EINVAL;
+    return nullptr;
+  }
+  count_allocation(size);
+  return __libc_memalign(alignment, size);
+}
+
+int
+posix_memalign(void ** pointer, size_t alignment, size_t size)
+{
+  if (0u == alignment || 0u != (alignment & (alignment - 1u)) ||
+    0u != alignment % sizeof(void *))
+  {
+    return EINVAL;
+  }
+  count_allocation(size);
+  void * result = __libc_memalign(alignment, size);
+  if (!result) {
+    return ENOMEM;
+  }
+  *pointer = result;
+  return 0;
+}
+
+void
+free(void * pointer)
+{
+  count_deallocation(pointer);
+  __libc_free(pointer);
+}
+
+}  // extern "C"
+#endif
@@ -0,0 +1,140 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/allocator/message_pool_allocator.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
+using rclcpp::allocator::MessagePoolRegistry;
+
+namespace
+{
+
+void *
+new_block(size_t size, size_t alignment)
+{
+  if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+    return ::operator new(size, std::align_val_t(alignment));
+  }
+  return ::operator new(size);
+}
+
+void
+delete_block(void * pointer, size_t alignment)
+{
+  if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+    ::operator delete(pointer, std::align_val_t(alignment));
+    return;
+  }
+  ::operator delete(pointer);
+}
+
+}  // namespace
+
+MessagePoolRegistry::MessagePoolRegistry()
+: max_cached_blocks_(64)
+{
+  for (auto & pool : pools_) {
+    pool.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+MessagePoolRegistry::~MessagePoolRegistry()
+{
+  // Pooled blocks are only kept by types which are not overaligned, see deallocate().
+  for (auto & pool : pools_) {
+    Pool * pool_ptr = pool.load(std::memory_order_acquire);
+    if (!pool_ptr) {
+      continue;
+    }
+    for (void * block : pool_ptr->free_blocks) {
+      ::operator delete(block);
+    }
+    delete pool_ptr;
+  }
+}
+
+size_t
+MessagePoolRegistry::next_type_slot()
+{
+  static std::atomic_size_t next_slot{0};
+  return next_slot.fetch_add(1, std::memory_order_relaxed);
+}
+
+MessagePoolRegistry::Pool *
+MessagePoolRegistry::get_pool(size_t slot)
+{
+  if (slot >= max_type_slots) {
+    return nullptr;
+  }
+  Pool * pool = pools_[slot].load(std::memory_order_acquire);
+  if (pool) {
+    return pool;
+  }
+  Pool * new_pool = new Pool();
+  if (pools_[slot].compare_exchange_strong(pool, new_pool, std::memory_order_acq_rel)) {
+    return new_pool;
+  }
+  // Another thread created it first.
+  delete new_pool;
+  return pool;
+}
+
+void *
+MessagePoolRegistry::allocate(size_t slot, size_t size, size_t alignment)
+{
+  Pool * pool = alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? get_pool(slot) : nullptr;
+  if (pool) {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    if (!pool->free_blocks.empty()) {
+      void * block = pool->free_blocks.back();
+      pool->free_blocks.pop_back();
+      return block;
+    }
+  }
+  return new_block(size, alignment);
+}
+
+void
+MessagePoolRegistry::deallocate(void * pointer, size_t slot, size_t alignment)
+{
+  if (!pointer) {
+    return;
+  }
+  // Overaligned blocks are never pooled, so the pools only hold blocks with default alignment.
+  Pool * pool = alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? get_pool(slot) : nullptr;
+  if (pool) {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    if (pool->free_blocks.size() < max_cached_blocks_.load(std::memory_order_relaxed)) {
+      pool->free_blocks.push_back(pointer);
+      return;
+    }
+  }
+  delete_block(pointer, alignment);
+}
+
+void
+MessagePoolRegistry::set_max_cached_blocks(size_t max_cached_blocks)
+{
+  max_cached_blocks_.store(max_cached_blocks, std::memory_order_relaxed);
+}
+
+size_t
+MessagePoolRegistry::get_max_cached_blocks() const
+{
+  return max_cached_blocks_.load(std::memory_order_relaxed);
+}
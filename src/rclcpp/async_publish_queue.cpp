@@ -0,0 +1,286 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/async_publish_queue.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "rcl/error_handling.h"
+#include "rcutils/logging_macros.h"
+
+#include "tracetools/tracetools.h"
+
+namespace rclcpp
+{
+
+namespace
+{
+
+void
+update_max(std::atomic<size_t> & max, size_t value)
+{
+  size_t current = max.load(std::memory_order_relaxed);
+  while (current < value &&
+    !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+  {
+  }
+}
+
+void
+update_max(std::atomic<int64_t> & max, int64_t value)
+{
+  int64_t current = max.load(std::memory_order_relaxed);
+  while (current < value &&
+    !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+  {
+  }
+}
+
+}  // namespace
+
+AsyncPublishQueue::AsyncPublishQueue(
+  std::shared_ptr<rcl_publisher_t> publisher_handle,
+  const AsyncPublishOptions & options)
+: publisher_handle_(std::move(publisher_handle)),
+  overflow_policy_(options.overflow_policy),
+  capacity_(options.capacity)
+{
+  if (0u == capacity_) {
+    throw std::invalid_argument("the asynchronous publish queue cannot be empty");
+  }
+  slots_ = std::make_unique<Slot[]>(capacity_);
+  for (size_t i = 0u; i < capacity_; ++i) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  thread_ = std::thread(&AsyncPublishQueue::run, this);
+}
+
+AsyncPublishQueue::~AsyncPublishQueue()
+{
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    stop_.store(true);
+  }
+  wake_condition_.notify_one();
+  thread_.join();
+}
+
+bool
+AsyncPublishQueue::push(std::shared_ptr<const void> ros_message)
+{
+  while (!try_push(ros_message)) {
+    if (AsyncPublishOverflowPolicy::DropNewest == overflow_policy_) {
+      dropped_count_.fetch_add(1u, std::memory_order_relaxed);
+      return false;
+    }
+    if (AsyncPublishOverflowPolicy::DropOldest == overflow_policy_) {
+      std::shared_ptr<const void> oldest;
+      std::chrono::steady_clock::time_point queued_time;
+      if (try_pop(oldest, queued_time)) {
+        dropped_count_.fetch_add(1u, std::memory_order_relaxed);
+      }
+    } else {
+      wait_for_room();
+    }
+  }
+  update_max(max_depth_, get_depth());
+
+  // Pairs with the fence of the publishing thread, so either it sees the new message before
+  // sleeping, or this thread sees that it is sleeping.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    wake_condition_.notify_one();
+  }
+  return true;
+}
+
+AsyncPublishStatistics
+AsyncPublishQueue::get_statistics() const
+{
+  const uint64_t published_count = published_count_.load(std::memory_order_relaxed);
+  const int64_t total_latency_ns = total_latency_ns_.load(std::memory_order_relaxed);
+  return {
+    get_depth(),
+    max_depth_.load(std::memory_order_relaxed),
+    published_count,
+    dropped_count_.load(std::memory_order_relaxed),
+    failed_count_.load(std::memory_order_relaxed),
+    std::chrono::nanoseconds(last_latency_ns_.load(std::memory_order_relaxed)),
+    std::chrono::nanoseconds(
+      0u == published_count ? 0 : total_latency_ns / static_cast<int64_t>(published_count)),
+    std::chrono::nanoseconds(max_latency_ns_.load(std::memory_order_relaxed))};
+}
+
+void
+AsyncPublishQueue::wait_for_room()
+{
+  std::unique_lock<std::mutex> lock(wake_mutex_);
+  blocked_producers_.fetch_add(1u, std::memory_order_relaxed);
+  // Pairs with the fence of the publishing thread, so either this thread sees the room it made
+  // before waiting, or it sees that this thread is waiting.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  room_condition_.wait(
+    lock, [this]() {
+      // A stale enqueue position means the queue changed, so pushing is tried again.
+      const size_t position = enqueue_position_.load(std::memory_order_relaxed);
+      const size_t sequence = slots_[position % capacity_].sequence.load(std::memory_order_acquire);
+      return static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position) >= 0;
+    });
+  blocked_producers_.fetch_sub(1u, std::memory_order_relaxed);
+}
+
+size_t
+AsyncPublishQueue::get_depth() const
+{
+  // The dequeue position is loaded first, so it is never ahead of the enqueue one.
+  const size_t dequeue_position = dequeue_position_.load(std::memory_order_relaxed);
+  const size_t enqueue_position = enqueue_position_.load(std::memory_order_relaxed);
+  return std::min(enqueue_position - dequeue_position, capacity_);
+}
+
+bool
+AsyncPublishQueue::try_push(std::shared_ptr<const void> & ros_message)
+{
+  // Bounded multi-producer multi-consumer queue, where the sequence of a slot tells whether it
+  // is free for the enqueue position, or holds the message of the dequeue position.
+  size_t position = enqueue_position_.load(std::memory_order_relaxed);
+  while (true) {
+    Slot & slot = slots_[position % capacity_];
+    const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+    if (0 == difference) {
+      if (enqueue_position_.compare_exchange_weak(
+          position, position + 1u, std::memory_order_relaxed))
+      {
+        slot.ros_message = std::move(ros_message);
+        slot.queued_time = std::chrono::steady_clock::now();
+        slot.sequence.store(position + 1u, std::memory_order_release);
+        return true;
+      }
+    } else if (difference < 0) {
+      // The slot still holds the message of the previous lap, the queue is full.
+      return false;
+    } else {
+      position = enqueue_position_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool
+AsyncPublishQueue::try_pop(
+  std::shared_ptr<const void> & ros_message, std::chrono::steady_clock::time_point & time)
+{
+  size_t position = dequeue_position_.load(std::memory_order_relaxed);
+  while (true) {
+    Slot & slot = slots_[position % capacity_];
+    const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    const auto difference =
+      static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1u);
+    if (0 == difference) {
+      if (dequeue_position_.compare_exchange_weak(
+          position, position + 1u, std::memory_order_relaxed))
+      {
+        ros_message = std::move(slot.ros_message);
+        time = slot.queued_time;
+        slot.sequence.store(position + capacity_, std::memory_order_release);
+        return true;
+      }
+    } else if (difference < 0) {
+      // The slot has not been written yet, the queue is empty.
+      return false;
+    } else {
+      position = dequeue_position_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void
+AsyncPublishQueue::run()
+{
+  std::shared_ptr<const void> ros_message;
+  std::chrono::steady_clock::time_point queued_time;
+  while (true) {
+    if (try_pop(ros_message, queued_time)) {
+      if (AsyncPublishOverflowPolicy::Block == overflow_policy_) {
+        // Pairs with the fence of wait_for_room().
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (blocked_producers_.load(std::memory_order_relaxed) > 0u) {
+          std::lock_guard<std::mutex> lock(wake_mutex_);
+          room_condition_.notify_one();
+        }
+      }
+      publish(ros_message.get(), queued_time);
+      ros_message.reset();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    if (stop_.load()) {
+      // Stopped, with every queued message published.
+      return;
+    }
+    sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wake_condition_.wait(
+      lock, [this]() {
+        const size_t position = dequeue_position_.load(std::memory_order_relaxed);
+        const Slot & slot = slots_[position % capacity_];
+        return stop_.load() || slot.sequence.load(std::memory_order_acquire) == position + 1u;
+      });
+    sleeping_.store(false, std::memory_order_relaxed);
+  }
+}
+
+void
+AsyncPublishQueue::publish(
+  const void * ros_message, std::chrono::steady_clock::time_point queued_time)
+{
+  TRACEPOINT(rclcpp_publish, nullptr, ros_message);
+  auto status = rcl_publish(publisher_handle_.get(), ros_message, nullptr);
+
+  if (RCL_RET_PUBLISHER_INVALID == status) {
+    rcl_reset_error();  // next call will reset error message if not context
+    if (rcl_publisher_is_valid_except_context(publisher_handle_.get())) {
+      rcl_context_t * context = rcl_publisher_get_context(publisher_handle_.get());
+      if (nullptr != context && !rcl_context_is_valid(context)) {
+        // publisher is invalid due to context being shutdown
+        return;
+      }
+    }
+  }
+  if (RCL_RET_OK != status) {
+    failed_count_.fetch_add(1u, std::memory_order_relaxed);
+    RCUTILS_LOG_ERROR_NAMED(
+      "rclcpp",
+      "failed to publish message asynchronously: %s", rcl_get_error_string().str);
+    rcl_reset_error();
+    return;
+  }
+
+  const int64_t latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - queued_time).count();
+  last_latency_ns_.store(latency_ns, std::memory_order_relaxed);
+  total_latency_ns_.fetch_add(latency_ns, std::memory_order_relaxed);
+  update_max(max_latency_ns_, latency_ns);
+  published_count_.fetch_add(1u, std::memory_order_relaxed);
+}
+
+}  // namespace rclcpp
@@ -14,6 +14,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -138,6 +139,43 @@ CallbackGroup::trigger_notify_guard_condition()
   }
 }
 
+void
+CallbackGroup::set_execution_budget(std::chrono::nanoseconds budget)
+{
+  execution_budget_ns_.store(budget.count(), std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds
+CallbackGroup::get_execution_budget() const
+{
+  return std::chrono::nanoseconds(execution_budget_ns_.load(std::memory_order_relaxed));
+}
+
+uint64_t
+CallbackGroup::get_overrun_count() const
+{
+  return overrun_count_.load(std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds
+CallbackGroup::get_worst_overrun_execution_time() const
+{
+  return std::chrono::nanoseconds(
+    worst_overrun_execution_time_ns_.load(std::memory_order_relaxed));
+}
+
+void
+CallbackGroup::record_overrun(std::chrono::nanoseconds execution_time)
+{
+  overrun_count_.fetch_add(1, std::memory_order_relaxed);
+  int64_t worst = worst_overrun_execution_time_ns_.load(std::memory_order_relaxed);
+  while (worst < execution_time.count() &&
+    !worst_overrun_execution_time_ns_.compare_exchange_weak(
+      worst, execution_time.count(), std::memory_order_relaxed))
+  {
+  }
+}
+
 void
 CallbackGroup::add_subscription(
   const rclcpp::SubscriptionBase::SharedPtr subscription_ptr)
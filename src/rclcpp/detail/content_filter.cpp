@@ -0,0 +1,829 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/detail/content_filter.hpp"
+
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+
+#include "rclcpp/message_field_accessor.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+namespace
+{
+
+enum class ValueType
+{
+  Bool,
+  Signed,
+  Unsigned,
+  Float,
+  String,
+};
+
+/// A value read from a message or a literal, strings are not copied.
+struct Value
+{
+  ValueType type;
+  union
+  {
+    bool bool_value;
+    int64_t signed_value;
+    uint64_t unsigned_value;
+    double float_value;
+  };
+  std::string_view string_value;
+};
+
+enum class RelOp
+{
+  Equal,
+  NotEqual,
+  Less,
+  LessEqual,
+  Greater,
+  GreaterEqual,
+};
+
+}  // namespace
+
+struct ContentFilter::Operand
+{
+  bool is_field = false;
+  rclcpp::FieldAccessor field;
+  // Literals.
+  Value literal{};
+  std::string literal_string;
+
+  ValueType
+  type() const;
+
+  Value
+  read(const void * ros_message) const;
+};
+
+struct ContentFilter::Node
+{
+  enum class Kind
+  {
+    And,
+    Or,
+    Not,
+    Compare,
+    Like,
+    Between,
+  };
+
+  explicit Node(Kind kind)
+  : kind(kind)
+  {}
+
+  Kind kind;
+  // Children of And, Or and Not.
+  size_t lhs = 0u;
+  size_t rhs = 0u;
+  // Operands of predicates.
+  RelOp op = RelOp::Equal;
+  Operand a;
+  Operand b;
+  Operand c;
+};
+
+namespace
+{
+
+ValueType
+value_type_of_field(uint8_t type_id)
+{
+  using namespace rosidl_typesupport_introspection_cpp;  // NOLINT
+  switch (type_id) {
+    case ROS_TYPE_FLOAT:
+    case ROS_TYPE_DOUBLE:
+    case ROS_TYPE_LONG_DOUBLE:
+      return ValueType::Float;
+    case ROS_TYPE_BOOLEAN:
+      return ValueType::Bool;
+    case ROS_TYPE_INT8:
+    case ROS_TYPE_INT16:
+    case ROS_TYPE_INT32:
+    case ROS_TYPE_INT64:
+      return ValueType::Signed;
+    case ROS_TYPE_CHAR:
+    case ROS_TYPE_WCHAR:
+    case ROS_TYPE_OCTET:
+    case ROS_TYPE_UINT8:
+    case ROS_TYPE_UINT16:
+    case ROS_TYPE_UINT32:
+    case ROS_TYPE_UINT64:
+      return ValueType::Unsigned;
+    case ROS_TYPE_STRING:
+      return ValueType::String;
+    default:
+      throw std::invalid_argument("unsupported field type in content filter");
+  }
+}
+
+template<typename T>
+const T &
+field_at(const void * ros_message, const rclcpp::FieldAccessor & field)
+{
+  return *static_cast<const T *>(field.get_pointer(ros_message));
+}
+
+bool
+is_numeric(ValueType type)
+{
+  return type != ValueType::String;
+}
+
+/// Compare two numeric values, return false if they are unordered (NaN).
+bool
+compare_numbers(const Value & a, const Value & b, int & result)
+{
+  auto as_unsigned = [](const Value & v) -> uint64_t {
+      return v.type == ValueType::Bool ? static_cast<uint64_t>(v.bool_value) : v.unsigned_value;
+    };
+  auto as_double = [&as_unsigned](const Value & v) -> double {
+      switch (v.type) {
+        case ValueType::Float:
+          return v.float_value;
+        case ValueType::Signed:
+          return static_cast<double>(v.signed_value);
+        default:
+          return static_cast<double>(as_unsigned(v));
+      }
+    };
+  if (a.type == ValueType::Float || b.type == ValueType::Float) {
+    const double x = as_double(a);
+    const double y = as_double(b);
+    if (std::isnan(x) || std::isnan(y)) {
+      return false;
+    }
+    result = (x < y) ? -1 : (x > y ? 1 : 0);
+    return true;
+  }
+  if (a.type == ValueType::Signed && b.type == ValueType::Signed) {
+    result = (a.signed_value < b.signed_value) ? -1 : (a.signed_value > b.signed_value ? 1 : 0);
+    return true;
+  }
+  if (a.type == ValueType::Signed && a.signed_value < 0) {
+    result = -1;
+    return true;
+  }
+  if (b.type == ValueType::Signed && b.signed_value < 0) {
+    result = 1;
+    return true;
+  }
+  const uint64_t x = a.type == ValueType::Signed ?
+    static_cast<uint64_t>(a.signed_value) : as_unsigned(a);
+  const uint64_t y = b.type == ValueType::Signed ?
+    static_cast<uint64_t>(b.signed_value) : as_unsigned(b);
+  result = (x < y) ? -1 : (x > y ? 1 : 0);
+  return true;
+}
+
+bool
+compare_values(const Value & a, const Value & b, int & result)
+{
+  if (a.type == ValueType::String) {
+    const int c = a.string_value.compare(b.string_value);
+    result = (c < 0) ? -1 : (c > 0 ? 1 : 0);
+    return true;
+  }
+  return compare_numbers(a, b, result);
+}
+
+bool
+apply(RelOp op, const Value & a, const Value & b)
+{
+  int result = 0;
+  if (!compare_values(a, b, result)) {
+    // Only "not equal" holds for unordered values.
+    return op == RelOp::NotEqual;
+  }
+  switch (op) {
+    case RelOp::Equal:
+      return result == 0;
+    case RelOp::NotEqual:
+      return result != 0;
+    case RelOp::Less:
+      return result < 0;
+    case RelOp::LessEqual:
+      return result <= 0;
+    case RelOp::Greater:
+      return result > 0;
+    case RelOp::GreaterEqual:
+      return result >= 0;
+  }
+  return false;
+}
+
+/// Match a string against a LIKE pattern, '%' matches any sequence and '_' any character.
+bool
+like(std::string_view text, std::string_view pattern)
+{
+  size_t t = 0u;
+  size_t p = 0u;
+  size_t star_p = std::string_view::npos;
+  size_t star_t = 0u;
+  while (t < text.size()) {
+    if (p < pattern.size() && (pattern[p] == '_' || pattern[p] == text[t])) {
+      ++t;
+      ++p;
+    } else if (p < pattern.size() && pattern[p] == '%') {
+      star_p = p++;
+      star_t = t;
+    } else if (star_p != std::string_view::npos) {
+      p = star_p + 1;
+      t = ++star_t;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '%') {
+    ++p;
+  }
+  return p == pattern.size();
+}
+
+struct Token
+{
+  enum class Kind
+  {
+    Identifier,
+    Number,
+    String,
+    Parameter,
+    Operator,
+    LeftParenthesis,
+    RightParenthesis,
+    End,
+  };
+
+  Kind kind;
+  std::string text;
+};
+
+std::vector<Token>
+tokenize(const std::string & expression)
+{
+  std::vector<Token> tokens;
+  size_t i = 0u;
+  while (i < expression.size()) {
+    const char c = expression[i];
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      ++i;
+    } else if (c == '(') {
+      tokens.push_back({Token::Kind::LeftParenthesis, "("});
+      ++i;
+    } else if (c == ')') {
+      tokens.push_back({Token::Kind::RightParenthesis, ")"});
+      ++i;
+    } else if (c == '\'' || c == '`') {
+      // The DDS grammar accepts both quotes, a quote is doubled to be escaped.
+      const char quote = c;
+      std::string text;
+      ++i;
+      while (true) {
+        if (i >= expression.size()) {
+          throw std::invalid_argument("unterminated string in content filter expression");
+        }
+        if (expression[i] == quote) {
+          if (i + 1 < expression.size() && expression[i + 1] == quote) {
+            text += quote;
+            i += 2;
+            continue;
+          }
+          ++i;
+          break;
+        }
+        text += expression[i++];
+      }
+      tokens.push_back({Token::Kind::String, std::move(text)});
+    } else if (c == '%') {
+      size_t end = i + 1;
+      while (end < expression.size() && std::isdigit(static_cast<unsigned char>(expression[end]))) {
+        ++end;
+      }
+      if (end == i + 1 || end - i - 1 > 2) {
+        throw std::invalid_argument("invalid parameter in content filter expression");
+      }
+      tokens.push_back({Token::Kind::Parameter, expression.substr(i + 1, end - i - 1)});
+      i = end;
+    } else if (c == '=' || c == '<' || c == '>' || c == '!') {
+      std::string text(1, c);
+      if (i + 1 < expression.size() &&
+        (expression[i + 1] == '=' || (c == '<' && expression[i + 1] == '>')))
+      {
+        text += expression[i + 1];
+      }
+      if (text == "!") {
+        throw std::invalid_argument("invalid operator in content filter expression");
+      }
+      tokens.push_back({Token::Kind::Operator, text});
+      i += text.size();
+    } else if (std::isdigit(static_cast<unsigned char>(c)) || c == '-' || c == '+' || c == '.') {
+      size_t end = i + 1;
+      while (end < expression.size()) {
+        const char d = expression[end];
+        const bool exponent_sign = (d == '-' || d == '+') &&
+          (expression[end - 1] == 'e' || expression[end - 1] == 'E');
+        if (!std::isalnum(static_cast<unsigned char>(d)) && d != '.' && !exponent_sign) {
+          break;
+        }
+        ++end;
+      }
+      tokens.push_back({Token::Kind::Number, expression.substr(i, end - i)});
+      i = end;
+    } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+      size_t end = i + 1;
+      while (end < expression.size()) {
+        const char d = expression[end];
+        if (!std::isalnum(static_cast<unsigned char>(d)) && d != '_' && d != '.') {
+          break;
+        }
+        ++end;
+      }
+      tokens.push_back({Token::Kind::Identifier, expression.substr(i, end - i)});
+      i = end;
+    } else {
+      throw std::invalid_argument(
+              std::string("unexpected character '") + c + "' in content filter expression");
+    }
+  }
+  tokens.push_back({Token::Kind::End, ""});
+  return tokens;
+}
+
+bool
+is_keyword(const Token & token, const char * keyword)
+{
+  if (token.kind != Token::Kind::Identifier) {
+    return false;
+  }
+  const std::string & text = token.text;
+  size_t i = 0u;
+  for (; keyword[i] != '\0'; ++i) {
+    if (i >= text.size() ||
+      std::toupper(static_cast<unsigned char>(text[i])) != keyword[i])
+    {
+      return false;
+    }
+  }
+  return i == text.size();
+}
+
+Value
+parse_number(const std::string & text)
+{
+  Value value{};
+  const char * begin = text.c_str();
+  char * end = nullptr;
+  const bool is_float = text.find_first_of(".eE") != std::string::npos &&
+    text.find_first_of("xX") == std::string::npos;
+  errno = 0;
+  if (is_float) {
+    value.type = ValueType::Float;
+    value.float_value = std::strtod(begin, &end);
+  } else if (text[0] == '-') {
+    value.type = ValueType::Signed;
+    value.signed_value = std::strtoll(begin, &end, 0);
+  } else {
+    value.type = ValueType::Unsigned;
+    value.unsigned_value = std::strtoull(begin, &end, 0);
+    if (value.unsigned_value <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+      value.type = ValueType::Signed;
+      value.signed_value = static_cast<int64_t>(value.unsigned_value);
+    }
+  }
+  if (end != begin + text.size() || errno == ERANGE) {
+    throw std::invalid_argument("invalid number '" + text + "' in content filter expression");
+  }
+  return value;
+}
+
+}  // namespace
+
+ValueType
+ContentFilter::Operand::type() const
+{
+  return is_field ? value_type_of_field(field.get_type_id()) : literal.type;
+}
+
+Value
+ContentFilter::Operand::read(const void * ros_message) const
+{
+  if (!is_field) {
+    return literal;
+  }
+  using namespace rosidl_typesupport_introspection_cpp;  // NOLINT
+  Value value{};
+  switch (field.get_type_id()) {
+    case ROS_TYPE_FLOAT:
+      value.type = ValueType::Float;
+      value.float_value = field_at<float>(ros_message, field);
+      break;
+    case ROS_TYPE_DOUBLE:
+      value.type = ValueType::Float;
+      value.float_value = field_at<double>(ros_message, field);
+      break;
+    case ROS_TYPE_LONG_DOUBLE:
+      value.type = ValueType::Float;
+      value.float_value = static_cast<double>(field_at<long double>(ros_message, field));
+      break;
+    case ROS_TYPE_BOOLEAN:
+      value.type = ValueType::Bool;
+      value.bool_value = field_at<bool>(ros_message, field);
+      break;
+    case ROS_TYPE_INT8:
+      value.type = ValueType::Signed;
+      value.signed_value = field_at<int8_t>(ros_message, field);
+      break;
+    case ROS_TYPE_INT16:
+      value.type = ValueType::Signed;
+      value.signed_value = field_at<int16_t>(ros_message, field);
+      break;
+    case ROS_TYPE_INT32:
+      value.type = ValueType::Signed;
+      value.signed_value = field_at<int32_t>(ros_message, field);
+      break;
+    case ROS_TYPE_INT64:
+      value.type = ValueType::Signed;
+      value.signed_value = field_at<int64_t>(ros_message, field);
+      break;
+    case ROS_TYPE_CHAR:
+    case ROS_TYPE_OCTET:
+    case ROS_TYPE_UINT8:
+      value.type = ValueType::Unsigned;
+      value.unsigned_value = field_at<uint8_t>(ros_message, field);
+      break;
+    case ROS_TYPE_WCHAR:
+    case ROS_TYPE_UINT16:
+      value.type = ValueType::Unsigned;
+      value.unsigned_value = field_at<uint16_t>(ros_message, field);
+      break;
+    case ROS_TYPE_UINT32:
+      value.type = ValueType::Unsigned;
+      value.unsigned_value = field_at<uint32_t>(ros_message, field);
+      break;
+    case ROS_TYPE_UINT64:
+      value.type = ValueType::Unsigned;
+      value.unsigned_value = field_at<uint64_t>(ros_message, field);
+      break;
+    case ROS_TYPE_STRING:
+      value.type = ValueType::String;
+      value.string_value = field_at<std::string>(ros_message, field);
+      break;
+  }
+  return value;
+}
+
+/// Recursive descent parser building the nodes of a filter.
+class ContentFilterParser
+{
+public:
+  ContentFilterParser(
+    const rclcpp::MessageFieldAccessors & accessors,
+    const std::vector<std::string> & expression_parameters,
+    std::vector<ContentFilter::Node> & nodes)
+  : accessors_(accessors), expression_parameters_(expression_parameters), nodes_(nodes)
+  {}
+
+  size_t
+  parse(const std::string & expression)
+  {
+    tokens_ = tokenize(expression);
+    position_ = 0u;
+    const size_t root = parse_or();
+    if (peek().kind != Token::Kind::End) {
+      throw std::invalid_argument(
+              "unexpected '" + peek().text + "' in content filter expression");
+    }
+    return root;
+  }
+
+private:
+  using Node = ContentFilter::Node;
+  using Operand = ContentFilter::Operand;
+
+  const Token &
+  peek() const
+  {
+    return tokens_[position_];
+  }
+
+  const Token &
+  next()
+  {
+    const Token & token = tokens_[position_];
+    if (token.kind != Token::Kind::End) {
+      ++position_;
+    }
+    return token;
+  }
+
+  size_t
+  add(Node node)
+  {
+    nodes_.push_back(std::move(node));
+    return nodes_.size() - 1u;
+  }
+
+  size_t
+  parse_or()
+  {
+    size_t lhs = parse_and();
+    while (is_keyword(peek(), "OR")) {
+      next();
+      Node node(Node::Kind::Or);
+      node.lhs = lhs;
+      node.rhs = parse_and();
+      lhs = add(std::move(node));
+    }
+    return lhs;
+  }
+
+  size_t
+  parse_and()
+  {
+    size_t lhs = parse_not();
+    while (is_keyword(peek(), "AND")) {
+      next();
+      Node node(Node::Kind::And);
+      node.lhs = lhs;
+      node.rhs = parse_not();
+      lhs = add(std::move(node));
+    }
+    return lhs;
+  }
+
+  size_t
+  parse_not()
+  {
+    if (is_keyword(peek(), "NOT")) {
+      next();
+      Node node(Node::Kind::Not);
+      node.lhs = parse_not();
+      return add(std::move(node));
+    }
+    if (peek().kind == Token::Kind::LeftParenthesis) {
+      next();
+      const size_t inner = parse_or();
+      if (next().kind != Token::Kind::RightParenthesis) {
+        throw std::invalid_argument("missing ')' in content filter expression");
+      }
+      return inner;
+    }
+    return parse_predicate();
+  }
+
+  size_t
+  parse_predicate()
+  {
+    Node node(Node::Kind::Compare);
+    node.a = parse_operand();
+    bool negate = false;
+    if (is_keyword(peek(), "NOT")) {
+      next();
+      negate = true;
+    }
+    if (is_keyword(peek(), "BETWEEN")) {
+      next();
+      node.kind = Node::Kind::Between;
+      node.b = parse_operand();
+      if (!is_keyword(next(), "AND")) {
+        throw std::invalid_argument("missing AND after BETWEEN in content filter expression");
+      }
+      node.c = parse_operand();
+      check_comparable(node.a, node.b);
+      check_comparable(node.a, node.c);
+    } else if (is_keyword(peek(), "LIKE")) {
+      next();
+      node.kind = Node::Kind::Like;
+      node.b = parse_operand();
+      if (node.a.type() != ValueType::String || node.b.type() != ValueType::String) {
+        throw std::invalid_argument("LIKE can only be used with strings in content filter");
+      }
+    } else if (!negate && peek().kind == Token::Kind::Operator) {
+      const std::string & op = next().text;
+      if (op == "=") {
+        node.op = RelOp::Equal;
+      } else if (op == "<>" || op == "!=") {
+        node.op = RelOp::NotEqual;
+      } else if (op == "<") {
+        node.op = RelOp::Less;
+      } else if (op == "<=") {
+        node.op = RelOp::LessEqual;
+      } else if (op == ">") {
+        node.op = RelOp::Greater;
+      } else if (op == ">=") {
+        node.op = RelOp::GreaterEqual;
+      } else {
+        throw std::invalid_argument("invalid operator '" + op + "' in content filter expression");
+      }
+      node.b = parse_operand();
+      check_comparable(node.a, node.b);
+    } else {
+      throw std::invalid_argument(
+              "expected a comparison after '" + tokens_[position_ - 1].text +
+              "' in content filter expression");
+    }
+    const size_t predicate = add(std::move(node));
+    if (!negate) {
+      return predicate;
+    }
+    Node not_node(Node::Kind::Not);
+    not_node.lhs = predicate;
+    return add(std::move(not_node));
+  }
+
+  static void
+  check_comparable(const Operand & a, const Operand & b)
+  {
+    if (is_numeric(a.type()) != is_numeric(b.type())) {
+      throw std::invalid_argument("comparison of a string with a number in content filter");
+    }
+  }
+
+  Operand
+  parse_operand()
+  {
+    const Token & token = next();
+    switch (token.kind) {
+      case Token::Kind::Identifier:
+        if (is_keyword(token, "TRUE") || is_keyword(token, "FALSE")) {
+          return make_literal(token);
+        }
+        return resolve_field(token.text);
+      case Token::Kind::Number:
+      case Token::Kind::String:
+        return make_literal(token);
+      case Token::Kind::Parameter:
+        {
+          const size_t index = std::stoul(token.text);
+          if (index >= expression_parameters_.size()) {
+            throw std::invalid_argument(
+                    "missing expression parameter %" + token.text + " for content filter");
+          }
+          const auto parameter_tokens = tokenize(expression_parameters_[index]);
+          if (parameter_tokens.size() != 2u ||
+            parameter_tokens[0].kind == Token::Kind::Parameter ||
+            (parameter_tokens[0].kind == Token::Kind::Identifier &&
+            !is_keyword(parameter_tokens[0], "TRUE") &&
+            !is_keyword(parameter_tokens[0], "FALSE")))
+          {
+            throw std::invalid_argument(
+                    "expression parameter %" + token.text + " of content filter isn't a literal");
+          }
+          return make_literal(parameter_tokens[0]);
+        }
+      default:
+        throw std::invalid_argument(
+                "expected a field or a value instead of '" + token.text +
+                "' in content filter expression");
+    }
+  }
+
+  static Operand
+  make_literal(const Token & token)
+  {
+    Operand operand;
+    switch (token.kind) {
+      case Token::Kind::Number:
+        operand.literal = parse_number(token.text);
+        break;
+      case Token::Kind::String:
+        operand.literal_string = token.text;
+        operand.literal.type = ValueType::String;
+        break;
+      case Token::Kind::Identifier:
+        operand.literal.type = ValueType::Bool;
+        operand.literal.bool_value = is_keyword(token, "TRUE");
+        break;
+      default:
+        throw std::invalid_argument("invalid literal in content filter expression");
+    }
+    return operand;
+  }
+
+  Operand
+  resolve_field(const std::string & path) const
+  {
+    Operand operand;
+    operand.is_field = true;
+    try {
+      operand.field = accessors_.get_field(path);
+    } catch (const std::invalid_argument & e) {
+      throw std::invalid_argument(std::string(e.what()) + " in content filter expression");
+    }
+    if (operand.field.get_type_id() == rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE) {
+      throw std::invalid_argument(
+              "field '" + path + "' of content filter expression is a message");
+    }
+    // Throws for unsupported types.
+    (void)operand.type();
+    return operand;
+  }
+
+  const rclcpp::MessageFieldAccessors & accessors_;
+  const std::vector<std::string> & expression_parameters_;
+  std::vector<ContentFilter::Node> & nodes_;
+  std::vector<Token> tokens_;
+  size_t position_ = 0u;
+};
+
+ContentFilter::ContentFilter(
+  const rosidl_message_type_support_t & type_support,
+  const std::string & filter_expression,
+  const std::vector<std::string> & expression_parameters)
+: filter_expression_(filter_expression),
+  expression_parameters_(expression_parameters),
+  root_(0u)
+{
+  const rclcpp::MessageFieldAccessors accessors(type_support);
+  ContentFilterParser parser(accessors, expression_parameters_, nodes_);
+  root_ = parser.parse(filter_expression_);
+
+  // Point the literal strings to their own storage, which doesn't move anymore.
+  for (auto & node : nodes_) {
+    for (Operand * operand : {&node.a, &node.b, &node.c}) {
+      if (!operand->is_field && operand->literal.type == ValueType::String) {
+        operand->literal.string_value = operand->literal_string;
+      }
+    }
+  }
+}
+
+ContentFilter::~ContentFilter()
+{}
+
+bool
+ContentFilter::evaluate(const void * ros_message) const
+{
+  return evaluate_node(root_, ros_message);
+}
+
+bool
+ContentFilter::evaluate_node(size_t index, const void * ros_message) const
+{
+  const Node & node = nodes_[index];
+  switch (node.kind) {
+    case Node::Kind::And:
+      return evaluate_node(node.lhs, ros_message) && evaluate_node(node.rhs, ros_message);
+    case Node::Kind::Or:
+      return evaluate_node(node.lhs, ros_message) || evaluate_node(node.rhs, ros_message);
+    case Node::Kind::Not:
+      return !evaluate_node(node.lhs, ros_message);
+    case Node::Kind::Compare:
+      return apply(node.op, node.a.read(ros_message), node.b.read(ros_message));
+    case Node::Kind::Like:
+      return like(node.a.read(ros_message).string_value, node.b.read(ros_message).string_value);
+    case Node::Kind::Between:
+      {
+        const Value value = node.a.read(ros_message);
+        return apply(RelOp::GreaterEqual, value, node.b.read(ros_message)) &&
+               apply(RelOp::LessEqual, value, node.c.read(ros_message));
+      }
+  }
+  return false;
+}
+
+const std::string &
+ContentFilter::get_filter_expression() const
+{
+  return filter_expression_;
+}
+
+const std::vector<std::string> &
+ContentFilter::get_expression_parameters() const
+{
+  return expression_parameters_;
+}
+
+}  // namespace detail
+}  // namespace rclcpp
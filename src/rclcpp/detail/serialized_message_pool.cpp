@@ -0,0 +1,83 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/detail/serialized_message_pool.hpp"
+
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace rclcpp
+{
+namespace detail
+{
+
+SerializedMessagePool::SerializedMessagePool(size_t max_cached)
+: max_cached_(max_cached)
+{
+  free_messages_.reserve(max_cached_);
+}
+
+SerializedMessagePool::~SerializedMessagePool()
+{}
+
+std::shared_ptr<rclcpp::SerializedMessage>
+SerializedMessagePool::acquire(size_t capacity)
+{
+  std::unique_ptr<rclcpp::SerializedMessage> message;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_messages_.empty()) {
+      message = std::move(free_messages_.back());
+      free_messages_.pop_back();
+    }
+  }
+  if (!message) {
+    message = std::make_unique<rclcpp::SerializedMessage>(capacity);
+  } else {
+    message->get_rcl_serialized_message().buffer_length = 0u;
+    if (message->capacity() < capacity) {
+      message->reserve(capacity);
+    }
+  }
+
+  std::weak_ptr<SerializedMessagePool> weak_pool = weak_from_this();
+  return std::shared_ptr<rclcpp::SerializedMessage>(
+    message.release(),
+    [weak_pool](rclcpp::SerializedMessage * message) {
+      auto pool = weak_pool.lock();
+      if (pool) {
+        pool->recycle(message);
+      } else {
+        delete message;
+      }
+    });
+}
+
+void
+SerializedMessagePool::recycle(rclcpp::SerializedMessage * message)
+{
+  std::unique_ptr<rclcpp::SerializedMessage> owned_message(message);
+  if (owned_message->is_external()) {
+    // The message was assigned external memory, don't keep it alive.
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (free_messages_.size() < max_cached_) {
+    free_messages_.push_back(std::move(owned_message));
+  }
+}
+
+}  // namespace detail
+}  // namespace rclcpp
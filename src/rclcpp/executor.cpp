@@ -14,7 +14,9 @@
 
 #include <algorithm>
 #include <memory>
+#include <memory_resource>
 #include <map>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -24,8 +26,11 @@
 #include "rcl/error_handling.h"
 #include "rcpputils/scope_exit.hpp"
 
+#include "rclcpp/allocator/allocator_common.hpp"
+#include "rclcpp/detail/wait_with_policy.hpp"
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/executor.hpp"
+#include "rclcpp/experimental/coroutine.hpp"
 #include "rclcpp/guard_condition.hpp"
 #include "rclcpp/memory_strategy.hpp"
 #include "rclcpp/node.hpp"
@@ -53,8 +58,19 @@ Executor::Executor(const rclcpp::ExecutorOptions & options)
 : spinning(false),
   interrupt_guard_condition_(options.context),
   shutdown_guard_condition_(std::make_shared<rclcpp::GuardCondition>(options.context)),
-  memory_strategy_(options.memory_strategy)
+  arena_(options.arena),
+  arena_allocator_(arena_ ? arena_.get() : std::pmr::get_default_resource()),
+  memory_strategy_(
+    arena_ ? rclcpp::memory_strategies::create_arena_strategy(arena_) : options.memory_strategy),
+  preallocate_messages_(options.preallocate_messages),
+  wait_policy_(options.wait_policy),
+  busy_poll_duration_(options.busy_poll_duration),
+  use_timer_queue_(options.use_timer_queue)
 {
+  if (use_timer_queue_ && !memory_strategy_->set_timer_queue_enabled(true)) {
+    throw std::invalid_argument("the memory strategy doesn't support the timer queue");
+  }
+
   // Store the context for later use.
   context_ = options.context;
 
@@ -73,6 +89,9 @@ Executor::Executor(const rclcpp::ExecutorOptions & options)
   // Put the executor's guard condition in
   memory_strategy_->add_guard_condition(interrupt_guard_condition_);
   rcl_allocator_t allocator = memory_strategy_->get_allocator();
+  if (arena_) {
+    allocator = rclcpp::allocator::get_rcl_allocator<char>(arena_allocator_);
+  }
 
   rcl_ret_t ret = rcl_wait_set_init(
     &wait_set_,
@@ -507,10 +526,51 @@ Executor::set_memory_strategy(rclcpp::memory_strategy::MemoryStrategy::SharedPtr
   if (memory_strategy == nullptr) {
     throw std::runtime_error("Received NULL memory strategy in executor.");
   }
+  if (use_timer_queue_ && !memory_strategy->set_timer_queue_enabled(true)) {
+    throw std::invalid_argument("the memory strategy doesn't support the timer queue");
+  }
   std::lock_guard<std::mutex> guard{mutex_};
   memory_strategy_ = memory_strategy;
 }
 
+size_t
+Executor::get_memory_high_water_mark() const
+{
+  if (!arena_) {
+    return 0;
+  }
+  return arena_->get_high_water_mark();
+}
+
+void
+Executor::set_overrun_callback(OverrunCallbackType callback)
+{
+  overrun_callback_ = std::move(callback);
+}
+
+void
+Executor::handle_overrun(const AnyExecutable & any_exec, std::chrono::nanoseconds execution_time)
+{
+  any_exec.callback_group->record_overrun(execution_time);
+#ifdef PICAS
+  if (demote_priority_on_overrun_) {
+    auto demote = [this](auto & entity) {
+        if (entity && entity->callback_priority > overrun_demotion_priority_) {
+          set_callback_priority(entity, overrun_demotion_priority_);
+        }
+      };
+    demote(any_exec.timer);
+    demote(any_exec.subscription);
+    demote(any_exec.service);
+    demote(any_exec.client);
+    demote(any_exec.waitable);
+  }
+#endif
+  if (overrun_callback_) {
+    overrun_callback_(any_exec, execution_time);
+  }
+}
+
 void
 Executor::execute_any_executable(AnyExecutable & any_exec)
 {
@@ -521,6 +581,12 @@ Executor::execute_any_executable(AnyExecutable & any_exec)
 
     return;
   }
+  // Only callbacks of groups with an execution budget are timed.
+  const std::chrono::nanoseconds budget = any_exec.callback_group->get_execution_budget();
+  std::chrono::steady_clock::time_point start;
+  if (budget > std::chrono::nanoseconds::zero()) {
+    start = std::chrono::steady_clock::now();
+  }
   if (any_exec.timer) {
 #ifdef PICAS_DEBUG
     RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "execute callback [timer callback].");
@@ -539,7 +605,7 @@ Executor::execute_any_executable(AnyExecutable & any_exec)
     TRACEPOINT(
       rclcpp_executor_execute,
       static_cast<const void *>(any_exec.subscription->get_subscription_handle().get()));
-    execute_subscription(any_exec.subscription);
+    execute_subscription(any_exec.subscription, preallocate_messages_);
   }
   if (any_exec.service) {
     #ifdef PICAS_DEBUG
@@ -561,6 +627,14 @@ Executor::execute_any_executable(AnyExecutable & any_exec)
 #endif
 
     any_exec.waitable->execute(any_exec.data);
+    rclcpp::experimental::detail::rethrow_coroutine_exception();
+  }
+  if (budget > std::chrono::nanoseconds::zero()) {
+    auto execution_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+    if (execution_time > budget) {
+      handle_overrun(any_exec, execution_time);
+    }
   }
   // Reset the callback_group, regardless of type
   any_exec.callback_group->can_be_taken_from().store(true);
@@ -575,13 +649,16 @@ Executor::execute_any_executable(AnyExecutable & any_exec)
   }
 }
 
+// The actions are taken as template parameters rather than std::function, so that wrapping
+// the lambdas doesn't allocate on every take.
+template<typename TakeActionT, typename HandleActionT>
 static
 void
 take_and_do_error_handling(
   const char * action_description,
   const char * topic_or_service_name,
-  std::function<bool()> take_action,
-  std::function<void()> handle_action)
+  TakeActionT && take_action,
+  HandleActionT && handle_action)
 {
   bool taken = false;
   try {
@@ -596,6 +673,8 @@ take_and_do_error_handling(
   }
   if (taken) {
     handle_action();
+    // The callback may be a coroutine, which returns even if an exception escapes it.
+    rclcpp::experimental::detail::rethrow_coroutine_exception();
   } else {
     // Message or Service was not taken for some reason.
     // Note that this can be normal, if the underlying middleware needs to
@@ -613,6 +692,14 @@ take_and_do_error_handling(
 
 void
 Executor::execute_subscription(rclcpp::SubscriptionBase::SharedPtr subscription)
+{
+  execute_subscription(subscription, false);
+}
+
+void
+Executor::execute_subscription(
+  const rclcpp::SubscriptionBase::SharedPtr & subscription,
+  bool use_receive_message)
 {
   rclcpp::MessageInfo message_info;
   message_info.get_rmw_message_info().from_intra_process = false;
@@ -620,7 +707,25 @@ Executor::execute_subscription(rclcpp::SubscriptionBase::SharedPtr subscription)
   if (subscription->is_serialized()) {
     // This is the case where a copy of the serialized message is taken from
     // the middleware via inter-process communication.
-    std::shared_ptr<SerializedMessage> serialized_msg = subscription->create_serialized_message();
+    // The subscription's receive message keeps its buffer capacity across takes, it's
+    // only unavailable if another thread is executing the same subscription.
+    std::shared_ptr<SerializedMessage> serialized_msg;
+    if (use_receive_message) {
+      serialized_msg = subscription->borrow_receive_serialized_message();
+    }
+    const bool borrowed = (nullptr != serialized_msg);
+    if (!borrowed) {
+      serialized_msg = subscription->create_serialized_message();
+    }
+    // Give the message back even if the callback throws, or the receive message stays borrowed.
+    RCPPUTILS_SCOPE_EXIT(
+    {
+      if (borrowed) {
+        subscription->return_receive_serialized_message(serialized_msg);
+      } else {
+        subscription->return_serialized_message(serialized_msg);
+      }
+    });
     take_and_do_error_handling(
       "taking a serialized message from topic",
       subscription->get_topic_name(),
@@ -629,7 +734,6 @@ Executor::execute_subscription(rclcpp::SubscriptionBase::SharedPtr subscription)
       {
         subscription->handle_serialized_message(serialized_msg, message_info);
       });
-    subscription->return_serialized_message(serialized_msg);
   } else if (subscription->can_loan_messages()) {
     // This is the case where a loaned message is taken from the middleware via
     // inter-process communication, given to the user for their callback,
@@ -670,13 +774,28 @@ Executor::execute_subscription(rclcpp::SubscriptionBase::SharedPtr subscription)
   } else {
     // This case is taking a copy of the message data from the middleware via
     // inter-process communication.
-    std::shared_ptr<void> message = subscription->create_message();
+    // As above, the subscription's receive message is used when available.
+    std::shared_ptr<void> message;
+    if (use_receive_message) {
+      message = subscription->borrow_receive_message();
+    }
+    const bool borrowed = (nullptr != message);
+    if (!borrowed) {
+      message = subscription->create_message();
+    }
+    RCPPUTILS_SCOPE_EXIT(
+    {
+      if (borrowed) {
+        subscription->return_receive_message(message);
+      } else {
+        subscription->return_message(message);
+      }
+    });
     take_and_do_error_handling(
       "taking a message from topic",
       subscription->get_topic_name(),
       [&]() {return subscription->take_type_erased(message.get(), message_info);},
       [&]() {subscription->handle_message(message, message_info);});
-    subscription->return_message(message);
   }
 }
 
@@ -684,6 +803,7 @@ void
 Executor::execute_timer(rclcpp::TimerBase::SharedPtr timer)
 {
   timer->execute_callback();
+  rclcpp::experimental::detail::rethrow_coroutine_exception();
 }
 
 void
@@ -730,7 +850,7 @@ Executor::wait_for_work(std::chrono::nanoseconds timeout)
       memory_strategy_->collect_entities(weak_groups_to_nodes_);// all the available groups' callbacks are stored in memory_strategy_
 
     if (has_invalid_weak_groups_or_nodes) {//remove invalid callbacks
-      std::vector<rclcpp::CallbackGroup::WeakPtr> invalid_group_ptrs;
+      std::pmr::vector<rclcpp::CallbackGroup::WeakPtr> invalid_group_ptrs(arena_allocator_);
       for (auto pair : weak_groups_to_nodes_) {
         auto weak_group_ptr = pair.first;
         auto weak_node_ptr = pair.second;
@@ -780,10 +900,28 @@ Executor::wait_for_work(std::chrono::nanoseconds timeout)
     if (!memory_strategy_->add_handles_to_wait_set(&wait_set_)) {
       throw std::runtime_error("Couldn't fill wait set");
     }
+
+    // Don't wait past the deadline of the timers kept out of the wait set.
+    std::chrono::nanoseconds time_until_next_timer = memory_strategy_->time_until_next_timer();
+    if (time_until_next_timer >= std::chrono::nanoseconds::zero() &&
+      (timeout < std::chrono::nanoseconds::zero() || time_until_next_timer < timeout))
+    {
+      timeout = time_until_next_timer;
+    }
   }
 
-  rcl_ret_t status =
-    rcl_wait(&wait_set_, std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count());
+  rcl_ret_t status = rclcpp::detail::wait_with_policy(
+    &wait_set_, timeout, wait_policy_, busy_poll_duration_,
+    [this]() {
+      std::lock_guard<std::mutex> guard(mutex_);
+      rcl_ret_t ret = rcl_wait_set_clear(&wait_set_);
+      if (ret != RCL_RET_OK) {
+        throw_from_rcl_error(ret, "Couldn't clear wait set");
+      }
+      if (!memory_strategy_->add_handles_to_wait_set(&wait_set_)) {
+        throw std::runtime_error("Couldn't fill wait set");
+      }
+    });
   if (status == RCL_RET_WAIT_SET_EMPTY) {
     RCUTILS_LOG_WARN_NAMED(
       "rclcpp",
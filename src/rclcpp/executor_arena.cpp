@@ -0,0 +1,152 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/executor_arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+
+using rclcpp::ExecutorArena;
+
+namespace
+{
+
+size_t
+size_class_of(size_t bytes)
+{
+  size_t size_class = 0u;
+  while ((static_cast<size_t>(1u) << size_class) < bytes) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+}  // namespace
+
+ExecutorArena::RegionUsage::RegionUsage(std::pmr::memory_resource * region)
+: region_(region)
+{}
+
+void *
+ExecutorArena::RegionUsage::do_allocate(size_t bytes, size_t alignment)
+{
+  void * pointer = region_->allocate(bytes, alignment);
+  bytes_taken += bytes;
+  return pointer;
+}
+
+void
+ExecutorArena::RegionUsage::do_deallocate(void * pointer, size_t bytes, size_t alignment)
+{
+  // The region is monotonic, so this doesn't free anything.
+  region_->deallocate(pointer, bytes, alignment);
+}
+
+bool
+ExecutorArena::RegionUsage::do_is_equal(const std::pmr::memory_resource & other) const noexcept
+{
+  return this == &other;
+}
+
+ExecutorArena::ExecutorArena(size_t capacity, bool allow_growth)
+: capacity_(capacity),
+  buffer_(std::make_unique<std::byte[]>(capacity)),
+  region_(
+    buffer_.get(), capacity,
+    allow_growth ? std::pmr::new_delete_resource() : std::pmr::null_memory_resource()),
+  region_usage_(&region_),
+  pools_(&region_usage_),
+  largest_pool_block_(pools_.options().largest_required_pool_block)
+{}
+
+ExecutorArena::~ExecutorArena() = default;
+
+size_t
+ExecutorArena::get_capacity() const
+{
+  return capacity_;
+}
+
+size_t
+ExecutorArena::get_bytes_in_use() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_in_use_;
+}
+
+size_t
+ExecutorArena::get_high_water_mark() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return region_usage_.bytes_taken;
+}
+
+void *
+ExecutorArena::do_allocate(size_t bytes, size_t alignment)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  void * pointer = bytes > largest_pool_block_ ?
+    allocate_large_block(bytes, alignment) : pools_.allocate(bytes, alignment);
+  bytes_in_use_ += bytes;
+  return pointer;
+}
+
+void
+ExecutorArena::do_deallocate(void * pointer, size_t bytes, size_t alignment)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (bytes > largest_pool_block_) {
+    deallocate_large_block(pointer, bytes);
+  } else {
+    pools_.deallocate(pointer, bytes, alignment);
+  }
+  bytes_in_use_ -= bytes;
+}
+
+void *
+ExecutorArena::allocate_large_block(size_t bytes, size_t alignment)
+{
+  // The pools hand large blocks to their upstream, which is monotonic and would never reuse
+  // them, so they are recycled here instead.
+  const size_t size_class = size_class_of(bytes);
+  for (FreeBlock ** link = &free_large_blocks_[size_class]; nullptr != *link;
+    link = &(*link)->next)
+  {
+    if (0u == reinterpret_cast<uintptr_t>(*link) % alignment) {
+      FreeBlock * block = *link;
+      *link = block->next;
+      return block;
+    }
+  }
+  return region_usage_.allocate(
+    static_cast<size_t>(1u) << size_class, std::max(alignment, alignof(FreeBlock)));
+}
+
+void
+ExecutorArena::deallocate_large_block(void * pointer, size_t bytes)
+{
+  const size_t size_class = size_class_of(bytes);
+  auto block = static_cast<FreeBlock *>(pointer);
+  block->next = free_large_blocks_[size_class];
+  free_large_blocks_[size_class] = block;
+}
+
+bool
+ExecutorArena::do_is_equal(const std::pmr::memory_resource & other) const noexcept
+{
+  return this == &other;
+}
@@ -24,6 +24,7 @@
 #include "rclcpp/memory_strategy.hpp"
 #include "rclcpp/executors/static_single_threaded_executor.hpp"
 #include "rclcpp/detail/add_guard_condition_to_rcl_wait_set.hpp"
+#include "rclcpp/detail/wait_with_policy.hpp"
 
 using rclcpp::executors::StaticExecutorEntitiesCollector;
 
@@ -62,7 +63,8 @@ StaticExecutorEntitiesCollector::~StaticExecutorEntitiesCollector()
 void
 StaticExecutorEntitiesCollector::init(
   rcl_wait_set_t * p_wait_set,
-  rclcpp::memory_strategy::MemoryStrategy::SharedPtr memory_strategy)
+  rclcpp::memory_strategy::MemoryStrategy::SharedPtr memory_strategy,
+  bool preallocate_messages)
 {
   // Empty initialize executable list
   exec_list_ = rclcpp::experimental::ExecutableList();
@@ -73,6 +75,7 @@ StaticExecutorEntitiesCollector::init(
     throw std::runtime_error("Received NULL memory strategy in executor waitable.");
   }
   memory_strategy_ = memory_strategy;
+  preallocate_messages_ = preallocate_messages;
 
   // Get memory strategy and executable list. Prepare wait_set_
   std::shared_ptr<void> shared_ptr;
@@ -192,6 +195,20 @@ StaticExecutorEntitiesCollector::fill_executable_list_from_map(
     group->find_subscription_ptrs_if(
       [this](const rclcpp::SubscriptionBase::SharedPtr & subscription) {
         if (subscription) {
+          if (preallocate_messages_ && !subscription->can_loan_messages()) {
+            // Allocate now, so that the first take while spinning doesn't
+            if (subscription->is_serialized()) {
+              auto message = subscription->borrow_receive_serialized_message();
+              if (message) {
+                subscription->return_receive_serialized_message(message);
+              }
+            } else {
+              auto message = subscription->borrow_receive_message();
+              if (message) {
+                subscription->return_receive_message(message);
+              }
+            }
+          }
           exec_list_.add_subscription(subscription);
         }
         return false;
@@ -254,8 +271,16 @@ StaticExecutorEntitiesCollector::refresh_wait_set(std::chrono::nanoseconds timeo
     throw std::runtime_error("Couldn't fill wait set");
   }
 
-  rcl_ret_t status =
-    rcl_wait(p_wait_set_, std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count());
+  rcl_ret_t status = rclcpp::detail::wait_with_policy(
+    p_wait_set_, timeout, wait_policy_, busy_poll_duration_,
+    [this]() {
+      if (rcl_wait_set_clear(p_wait_set_) != RCL_RET_OK) {
+        throw std::runtime_error("Couldn't clear wait set");
+      }
+      if (!memory_strategy_->add_handles_to_wait_set(p_wait_set_)) {
+        throw std::runtime_error("Couldn't fill wait set");
+      }
+    });
 
   if (status == RCL_RET_WAIT_SET_EMPTY) {
     RCUTILS_LOG_WARN_NAMED(
@@ -267,6 +292,15 @@ StaticExecutorEntitiesCollector::refresh_wait_set(std::chrono::nanoseconds timeo
   }
 }
 
+void
+StaticExecutorEntitiesCollector::set_wait_policy(
+  rclcpp::ExecutorWaitPolicy wait_policy,
+  std::chrono::nanoseconds busy_poll_duration)
+{
+  wait_policy_ = wait_policy;
+  busy_poll_duration_ = busy_poll_duration;
+}
+
 void
 StaticExecutorEntitiesCollector::add_to_wait_set(rcl_wait_set_t * wait_set)
 {
@@ -438,8 +472,7 @@ StaticExecutorEntitiesCollector::is_ready(rcl_wait_set_t * p_wait_set)
     if (p_wait_set->guard_conditions[i] != NULL) {
       auto found_guard_condition = std::find_if(
         weak_nodes_to_guard_conditions_.begin(), weak_nodes_to_guard_conditions_.end(),
-        [&](std::pair<rclcpp::node_interfaces::NodeBaseInterface::WeakPtr,
-        const GuardCondition *> pair) -> bool {
+        [&](const WeakNodesToGuardConditionsMap::value_type & pair) -> bool {
           const rcl_guard_condition_t & rcl_gc = pair.second->get_rcl_guard_condition();
           return &rcl_gc == p_wait_set->guard_conditions[i];
         });
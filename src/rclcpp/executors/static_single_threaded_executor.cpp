@@ -21,6 +21,8 @@
 
 #include "rcpputils/scope_exit.hpp"
 
+#include "rclcpp/experimental/coroutine.hpp"
+
 using rclcpp::executors::StaticSingleThreadedExecutor;
 using rclcpp::experimental::ExecutableList;
 
@@ -29,6 +31,13 @@ StaticSingleThreadedExecutor::StaticSingleThreadedExecutor(
 : rclcpp::Executor(options)
 {
   entities_collector_ = std::make_shared<StaticExecutorEntitiesCollector>();
+  entities_collector_->set_wait_policy(wait_policy_, busy_poll_duration_);
+  // The executable list relies on every timer being in the wait set, so the option is dropped,
+  // which also keeps set_memory_strategy() from enabling the timer queue again.
+  if (use_timer_queue_) {
+    use_timer_queue_ = false;
+    memory_strategy_->set_timer_queue_enabled(false);
+  }
 }
 
 StaticSingleThreadedExecutor::~StaticSingleThreadedExecutor()
@@ -48,7 +57,7 @@ StaticSingleThreadedExecutor::spin()
 
   // Set memory_strategy_ and exec_list_ based on weak_nodes_
   // Prepare wait_set_ based on memory_strategy_
-  entities_collector_->init(&wait_set_, memory_strategy_);
+  entities_collector_->init(&wait_set_, memory_strategy_, preallocate_messages_);
 
   while (rclcpp::ok(this->context_) && spinning.load()) {
     // Refresh wait set and wait for work
@@ -82,7 +91,7 @@ StaticSingleThreadedExecutor::spin_some_impl(std::chrono::nanoseconds max_durati
 {
   // Make sure the entities collector has been initialized
   if (!entities_collector_->is_init()) {
-    entities_collector_->init(&wait_set_, memory_strategy_);
+    entities_collector_->init(&wait_set_, memory_strategy_, preallocate_messages_);
   }
 
   auto start = std::chrono::steady_clock::now();
@@ -119,7 +128,7 @@ StaticSingleThreadedExecutor::spin_once_impl(std::chrono::nanoseconds timeout)
 {
   // Make sure the entities collector has been initialized
   if (!entities_collector_->is_init()) {
-    entities_collector_->init(&wait_set_, memory_strategy_);
+    entities_collector_->init(&wait_set_, memory_strategy_, preallocate_messages_);
   }
 
   if (rclcpp::ok(context_) && spinning.load()) {
@@ -214,11 +223,13 @@ StaticSingleThreadedExecutor::execute_ready_executables(bool spin_once)
 {
   bool any_ready_executable = false;
 
+  // Entities are accessed by reference into the executable list, so that executing them
+  // doesn't touch the reference counts of the shared pointers.
   // Execute all the ready subscriptions
   for (size_t i = 0; i < wait_set_.size_of_subscriptions; ++i) {
     if (i < entities_collector_->get_number_of_subscriptions()) {
       if (wait_set_.subscriptions[i]) {
-        execute_subscription(entities_collector_->get_subscription(i));
+        execute_subscription(entities_collector_->get_subscription(i), preallocate_messages_);
         if (spin_once) {
           return true;
         }
@@ -229,10 +240,11 @@ StaticSingleThreadedExecutor::execute_ready_executables(bool spin_once)
   // Execute all the ready timers
   for (size_t i = 0; i < wait_set_.size_of_timers; ++i) {
     if (i < entities_collector_->get_number_of_timers()) {
-      if (wait_set_.timers[i] && entities_collector_->get_timer(i)->is_ready()) {
-        auto timer = entities_collector_->get_timer(i);
+      const auto & timer = entities_collector_->get_timer(i);
+      if (wait_set_.timers[i] && timer->is_ready()) {
         timer->call();
-        execute_timer(std::move(timer));
+        timer->execute_callback();
+        rclcpp::experimental::detail::rethrow_coroutine_exception();
         if (spin_once) {
           return true;
         }
@@ -266,10 +278,12 @@ StaticSingleThreadedExecutor::execute_ready_executables(bool spin_once)
   }
   // Execute all the ready waitables
   for (size_t i = 0; i < entities_collector_->get_number_of_waitables(); ++i) {
+    // Held by copy, since executing the entities collector refills the executable list
     auto waitable = entities_collector_->get_waitable(i);
     if (waitable->is_ready(&wait_set_)) {
       auto data = waitable->take_data();
       waitable->execute(data);
+      rclcpp::experimental::detail::rethrow_coroutine_exception();
       if (spin_once) {
         return true;
       }
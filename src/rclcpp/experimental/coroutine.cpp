@@ -0,0 +1,66 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/experimental/coroutine.hpp"
+
+#include <exception>
+#include <utility>
+
+namespace rclcpp
+{
+namespace experimental
+{
+namespace detail
+{
+
+namespace
+{
+
+// Defined in the library, so that every module uses the same one.
+std::exception_ptr &
+get_coroutine_exception()
+{
+  static thread_local std::exception_ptr exception;
+  return exception;
+}
+
+}  // namespace
+
+void
+set_coroutine_exception(std::exception_ptr exception)
+{
+  std::exception_ptr & current = get_coroutine_exception();
+  if (!current) {
+    current = std::move(exception);
+  }
+}
+
+std::exception_ptr
+take_coroutine_exception()
+{
+  return std::exchange(get_coroutine_exception(), nullptr);
+}
+
+void
+rethrow_coroutine_exception()
+{
+  std::exception_ptr exception = take_coroutine_exception();
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+}  // namespace detail
+}  // namespace experimental
+}  // namespace rclcpp
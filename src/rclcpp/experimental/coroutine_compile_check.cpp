@@ -0,0 +1,96 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Built as C++20 only to check that rclcpp/experimental/coroutine.hpp compiles, as it is
+// header only and empty in the C++17 build of rclcpp.
+
+#include "rclcpp/experimental/coroutine.hpp"
+
+#include <chrono>
+#include <memory>
+
+#include "rcl_interfaces/msg/log.hpp"
+#include "rcl_interfaces/srv/list_parameters.hpp"
+
+#include "rclcpp/node.hpp"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+namespace rclcpp
+{
+namespace experimental
+{
+namespace detail
+{
+
+CoroutineScheduler::SharedPtr
+check_create_coroutine_scheduler(rclcpp::Node::SharedPtr node)
+{
+  return create_coroutine_scheduler(node);
+}
+
+CoroutineTask
+check_coroutine_awaiters(
+  rclcpp::Node::SharedPtr node,
+  CoroutineScheduler::SharedPtr scheduler,
+  rclcpp::Client<rcl_interfaces::srv::ListParameters>::SharedPtr client,
+  CoroutineChannel<int> & channel)
+{
+  auto request = std::make_shared<rcl_interfaces::srv::ListParameters::Request>();
+  auto response = co_await scheduler->async_response(client, request);
+  co_await scheduler->sleep_for(node, std::chrono::milliseconds(1));
+  int value = co_await channel.next();
+  (void) response;
+  (void) value;
+}
+
+void
+check_coroutine_callbacks(rclcpp::Node::SharedPtr node, CoroutineScheduler::SharedPtr scheduler)
+{
+  using rcl_interfaces::msg::Log;
+  using rcl_interfaces::srv::ListParameters;
+
+  auto subscription = node->create_subscription<Log>(
+    "log", 10,
+    [node, scheduler](Log::ConstSharedPtr log) -> CoroutineTask {
+      co_await scheduler->sleep_for(node, std::chrono::milliseconds(1));
+      (void) log;
+    });
+  auto timer = node->create_wall_timer(
+    std::chrono::milliseconds(1),
+    [node, scheduler]() -> CoroutineTask {
+      co_await scheduler->sleep_for(node, std::chrono::milliseconds(1));
+    });
+  // The response is sent once the coroutine completes, so it is deferred.
+  auto service = node->create_service<ListParameters>(
+    "list_parameters",
+    [node, scheduler](
+      std::shared_ptr<rclcpp::Service<ListParameters>> service,
+      std::shared_ptr<rmw_request_id_t> request_header,
+      std::shared_ptr<ListParameters::Request> request) -> CoroutineTask {
+      co_await scheduler->sleep_for(node, std::chrono::milliseconds(1));
+      (void) request;
+      ListParameters::Response response;
+      service->send_response(*request_header, response);
+    });
+  (void) subscription;
+  (void) timer;
+  (void) service;
+}
+
+}  // namespace detail
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
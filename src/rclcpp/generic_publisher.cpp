@@ -16,12 +16,49 @@
 #include "rclcpp/generic_publisher.hpp"
 
 #include <memory>
+#include <stdexcept>
 #include <string>
 
 namespace rclcpp
 {
 
 void GenericPublisher::publish(const rclcpp::SerializedMessage & message)
+{
+  if (intra_process_is_enabled_) {
+    bool inter_process_publish_needed =
+      get_subscription_count() > get_intra_process_subscription_count();
+    // Messages referring to external memory are shared by the copy, not copied.
+    do_serialized_intra_process_publish(std::make_shared<const rclcpp::SerializedMessage>(message));
+    if (!inter_process_publish_needed) {
+      return;
+    }
+  }
+  publish_inter_process(message);
+}
+
+void GenericPublisher::publish(std::shared_ptr<const rclcpp::SerializedMessage> message)
+{
+  if (!message) {
+    throw std::invalid_argument("cannot publish a serialized message which is a null pointer");
+  }
+  if (intra_process_is_enabled_) {
+    bool inter_process_publish_needed =
+      get_subscription_count() > get_intra_process_subscription_count();
+    do_serialized_intra_process_publish(message);
+    if (!inter_process_publish_needed) {
+      return;
+    }
+  }
+  publish_inter_process(*message);
+}
+
+std::shared_ptr<rclcpp::SerializedMessage>
+GenericPublisher::borrow_serialized_message(size_t capacity)
+{
+  return serialized_message_pool_->acquire(capacity);
+}
+
+void GenericPublisher::publish_inter_process(const rclcpp::SerializedMessage & message)
 {
   auto return_code = rcl_publish_serialized_message(
     get_publisher_handle().get(), &message.get_rcl_serialized_message(), NULL);
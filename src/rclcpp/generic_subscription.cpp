@@ -32,7 +32,7 @@ std::shared_ptr<void> GenericSubscription::create_message()
 
 std::shared_ptr<rclcpp::SerializedMessage> GenericSubscription::create_serialized_message()
 {
-  return std::make_shared<rclcpp::SerializedMessage>(0);
+  return serialized_message_pool_->acquire();
 }
 
 void GenericSubscription::handle_message(
@@ -14,9 +14,12 @@
 
 #include "rclcpp/experimental/intra_process_manager.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 namespace rclcpp
 {
@@ -51,7 +54,8 @@ IntraProcessManager::add_publisher(rclcpp::PublisherBase::SharedPtr publisher)
     }
     if (can_communicate(publisher, subscription)) {
       uint64_t sub_id = pair.first;
-      insert_sub_id_for_pub(sub_id, pub_id, subscription->use_take_shared_method());
+      insert_sub_id_for_pub(
+        sub_id, pub_id, subscription->use_take_shared_method(), subscription->is_serialized());
     }
   }
 
@@ -75,7 +79,8 @@ IntraProcessManager::add_subscription(SubscriptionIntraProcessBase::SharedPtr su
     }
     if (can_communicate(publisher, subscription)) {
       uint64_t pub_id = pair.first;
-      insert_sub_id_for_pub(sub_id, pub_id, subscription->use_take_shared_method());
+      insert_sub_id_for_pub(
+        sub_id, pub_id, subscription->use_take_shared_method(), subscription->is_serialized());
     }
   }
 
@@ -103,6 +108,13 @@ IntraProcessManager::remove_subscription(uint64_t intra_process_subscription_id)
         pair.second.take_ownership_subscriptions.end(),
         intra_process_subscription_id),
       pair.second.take_ownership_subscriptions.end());
+
+    pair.second.serialized_subscriptions.erase(
+      std::remove(
+        pair.second.serialized_subscriptions.begin(),
+        pair.second.serialized_subscriptions.end(),
+        intra_process_subscription_id),
+      pair.second.serialized_subscriptions.end());
   }
 }
 
@@ -148,11 +160,36 @@ IntraProcessManager::get_subscription_count(uint64_t intra_process_publisher_id)
 
   auto count =
     publisher_it->second.take_shared_subscriptions.size() +
-    publisher_it->second.take_ownership_subscriptions.size();
+    publisher_it->second.take_ownership_subscriptions.size() +
+    publisher_it->second.serialized_subscriptions.size();
 
   return count;
 }
 
+void
+IntraProcessManager::do_serialized_intra_process_publish(
+  uint64_t intra_process_publisher_id,
+  std::shared_ptr<const rclcpp::SerializedMessage> message)
+{
+  std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+
+  auto publisher_it = pub_to_subs_.find(intra_process_publisher_id);
+  if (publisher_it == pub_to_subs_.end()) {
+    // Publisher is either invalid or no longer exists.
+    RCLCPP_WARN(
+      rclcpp::get_logger("rclcpp"),
+      "Calling do_serialized_intra_process_publish for invalid or no longer existing "
+      "publisher id");
+    return;
+  }
+  const auto & sub_ids = publisher_it->second;
+
+  // The typed subscriptions deserialize into their own message, so they can all share it.
+  add_shared_serialized_msg_to_buffers(message, sub_ids.take_shared_subscriptions);
+  add_shared_serialized_msg_to_buffers(message, sub_ids.take_ownership_subscriptions);
+  add_shared_serialized_msg_to_buffers(std::move(message), sub_ids.serialized_subscriptions);
+}
+
 SubscriptionIntraProcessBase::SharedPtr
 IntraProcessManager::get_subscription_intra_process(uint64_t intra_process_subscription_id)
 {
@@ -198,15 +235,55 @@ void
 IntraProcessManager::insert_sub_id_for_pub(
   uint64_t sub_id,
   uint64_t pub_id,
-  bool use_take_shared_method)
+  bool use_take_shared_method,
+  bool is_serialized)
 {
-  if (use_take_shared_method) {
+  if (is_serialized) {
+    pub_to_subs_[pub_id].serialized_subscriptions.push_back(sub_id);
+  } else if (use_take_shared_method) {
     pub_to_subs_[pub_id].take_shared_subscriptions.push_back(sub_id);
   } else {
     pub_to_subs_[pub_id].take_ownership_subscriptions.push_back(sub_id);
   }
 }
 
+void
+IntraProcessManager::remove_filtered_out_subscriptions(
+  const void * ros_message,
+  std::vector<uint64_t> & subscription_ids) const
+{
+  auto filtered_out =
+    [this, ros_message](uint64_t id) {
+      auto subscription_it = subscriptions_.find(id);
+      if (subscription_it == subscriptions_.end()) {
+        return false;
+      }
+      auto subscription = subscription_it->second.lock();
+      return subscription != nullptr && !subscription->matches_content_filter(ros_message);
+    };
+  subscription_ids.erase(
+    std::remove_if(subscription_ids.begin(), subscription_ids.end(), filtered_out),
+    subscription_ids.end());
+}
+
+void
+IntraProcessManager::add_shared_serialized_msg_to_buffers(
+  std::shared_ptr<const rclcpp::SerializedMessage> message,
+  const std::vector<uint64_t> & subscription_ids)
+{
+  for (auto id : subscription_ids) {
+    auto subscription_it = subscriptions_.find(id);
+    if (subscription_it == subscriptions_.end()) {
+      throw std::runtime_error("subscription has unexpectedly gone out of scope");
+    }
+    auto subscription = subscription_it->second.lock();
+    if (subscription == nullptr) {
+      continue;
+    }
+    subscription->provide_serialized_intra_process_message(message);
+  }
+}
+
 bool
 IntraProcessManager::can_communicate(
   rclcpp::PublisherBase::SharedPtr pub,
@@ -15,6 +15,7 @@
 #include "rclcpp/memory_strategies.hpp"
 
 #include <memory>
+#include <stdexcept>
 
 #include "rclcpp/strategies/allocator_memory_strategy.hpp"
 
@@ -25,3 +26,14 @@ rclcpp::memory_strategies::create_default_strategy()
 {
   return std::make_shared<AllocatorMemoryStrategy<>>();
 }
+
+rclcpp::memory_strategy::MemoryStrategy::SharedPtr
+rclcpp::memory_strategies::create_arena_strategy(std::shared_ptr<rclcpp::ExecutorArena> arena)
+{
+  if (!arena) {
+    throw std::invalid_argument("arena cannot be null");
+  }
+  using ArenaAllocator = rclcpp::ExecutorArena::Allocator<char>;
+  return std::make_shared<AllocatorMemoryStrategy<ArenaAllocator>>(
+    std::make_shared<ArenaAllocator>(arena.get()));
+}
@@ -17,6 +17,18 @@
 
 using rclcpp::memory_strategy::MemoryStrategy;
 
+bool
+MemoryStrategy::set_timer_queue_enabled(bool enabled)
+{
+  return !enabled;
+}
+
+std::chrono::nanoseconds
+MemoryStrategy::time_until_next_timer() const
+{
+  return std::chrono::nanoseconds(-1);
+}
+
 rclcpp::SubscriptionBase::SharedPtr
 MemoryStrategy::get_subscription_by_handle(
   const std::shared_ptr<const rcl_subscription_t> & subscriber_handle,
@@ -0,0 +1,172 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/message_field_accessor.hpp"
+
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "rcutils/error_handling.h"
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+#include "rosidl_typesupport_introspection_cpp/identifier.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+
+#include "rclcpp/typesupport_helpers.hpp"
+
+namespace rclcpp
+{
+
+namespace
+{
+
+using rosidl_typesupport_introspection_cpp::MessageMember;
+using rosidl_typesupport_introspection_cpp::MessageMembers;
+
+size_t
+size_of_field(const MessageMember & member)
+{
+  using namespace rosidl_typesupport_introspection_cpp;  // NOLINT
+  switch (member.type_id_) {
+    case ROS_TYPE_FLOAT:
+      return sizeof(float);
+    case ROS_TYPE_DOUBLE:
+      return sizeof(double);
+    case ROS_TYPE_LONG_DOUBLE:
+      return sizeof(long double);
+    case ROS_TYPE_CHAR:
+    case ROS_TYPE_OCTET:
+    case ROS_TYPE_UINT8:
+    case ROS_TYPE_INT8:
+      return 1u;
+    case ROS_TYPE_BOOLEAN:
+      return sizeof(bool);
+    case ROS_TYPE_WCHAR:
+    case ROS_TYPE_UINT16:
+    case ROS_TYPE_INT16:
+      return 2u;
+    case ROS_TYPE_UINT32:
+    case ROS_TYPE_INT32:
+      return 4u;
+    case ROS_TYPE_UINT64:
+    case ROS_TYPE_INT64:
+      return 8u;
+    case ROS_TYPE_STRING:
+      return sizeof(std::string);
+    case ROS_TYPE_WSTRING:
+      return sizeof(std::u16string);
+    case ROS_TYPE_MESSAGE:
+      return static_cast<const MessageMembers *>(member.members_->data)->size_of_;
+    default:
+      throw std::invalid_argument("unknown field type in introspection type support");
+  }
+}
+
+}  // namespace
+
+MessageFieldAccessors::MessageFieldAccessors(
+  const rosidl_message_type_support_t & type_support,
+  std::shared_ptr<rcpputils::SharedLibrary> library)
+: library_(std::move(library))
+{
+  const rosidl_message_type_support_t * introspection_type_support =
+    get_message_typesupport_handle(
+    &type_support, rosidl_typesupport_introspection_cpp::typesupport_identifier);
+  if (nullptr == introspection_type_support) {
+    rcutils_reset_error();
+    throw std::invalid_argument(
+            "field accessors require the rosidl_typesupport_introspection_cpp type support");
+  }
+  members_ = introspection_type_support->data;
+}
+
+MessageFieldAccessors::~MessageFieldAccessors()
+{}
+
+FieldAccessor
+MessageFieldAccessors::get_field(const std::string & path) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = fields_.find(path);
+  if (it == fields_.end()) {
+    it = fields_.emplace(path, resolve_field(path)).first;
+  }
+  return it->second;
+}
+
+size_t
+MessageFieldAccessors::get_message_size() const
+{
+  return static_cast<const MessageMembers *>(members_)->size_of_;
+}
+
+FieldAccessor
+MessageFieldAccessors::resolve_field(const std::string & path) const
+{
+  const auto * members = static_cast<const MessageMembers *>(members_);
+  size_t offset = 0u;
+  size_t begin = 0u;
+  while (true) {
+    const size_t end = path.find('.', begin);
+    const std::string name = path.substr(begin, end - begin);
+    const MessageMember * member = nullptr;
+    for (uint32_t i = 0u; i < members->member_count_; ++i) {
+      if (name == members->members_[i].name_) {
+        member = &members->members_[i];
+        break;
+      }
+    }
+    if (nullptr == member) {
+      throw std::invalid_argument("unknown field '" + path + "'");
+    }
+    if (member->is_array_) {
+      throw std::invalid_argument("field '" + path + "' is in an array, which isn't supported");
+    }
+    offset += member->offset_;
+    if (end == std::string::npos) {
+      return FieldAccessor(offset, member->type_id_, size_of_field(*member));
+    }
+    if (member->type_id_ != rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE) {
+      throw std::invalid_argument("field '" + name + "' of '" + path + "' has no member");
+    }
+    members = static_cast<const MessageMembers *>(member->members_->data);
+    begin = end + 1u;
+  }
+}
+
+MessageFieldAccessors::ConstSharedPtr
+get_message_field_accessors(const std::string & type)
+{
+  static std::mutex mutex;
+  static std::unordered_map<std::string, MessageFieldAccessors::ConstSharedPtr> accessors;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = accessors.find(type);
+  if (it != accessors.end()) {
+    return it->second;
+  }
+  auto library = rclcpp::get_typesupport_library(
+    type, rosidl_typesupport_introspection_cpp::typesupport_identifier);
+  const rosidl_message_type_support_t * type_support = rclcpp::get_typesupport_handle(
+    type, rosidl_typesupport_introspection_cpp::typesupport_identifier, *library);
+  auto type_accessors = std::make_shared<const MessageFieldAccessors>(
+    *type_support, std::move(library));
+  accessors.emplace(type, type_accessors);
+  return type_accessors;
+}
+
+}  // namespace rclcpp
@@ -0,0 +1,487 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/partial_deserialization.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rcpputils/asserts.hpp"
+#include "rcutils/error_handling.h"
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+#include "rosidl_typesupport_introspection_cpp/identifier.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+
+namespace rclcpp
+{
+
+namespace
+{
+
+using rosidl_typesupport_introspection_cpp::MessageMember;
+using rosidl_typesupport_introspection_cpp::MessageMembers;
+
+/// Size of a primitive field in CDR, 0 for strings and messages.
+size_t
+cdr_primitive_size(uint8_t type_id)
+{
+  using namespace rosidl_typesupport_introspection_cpp;  // NOLINT
+  switch (type_id) {
+    case ROS_TYPE_BOOLEAN:
+    case ROS_TYPE_CHAR:
+    case ROS_TYPE_OCTET:
+    case ROS_TYPE_UINT8:
+    case ROS_TYPE_INT8:
+      return 1u;
+    case ROS_TYPE_UINT16:
+    case ROS_TYPE_INT16:
+      return 2u;
+    case ROS_TYPE_FLOAT:
+    case ROS_TYPE_UINT32:
+    case ROS_TYPE_INT32:
+      return 4u;
+    case ROS_TYPE_DOUBLE:
+    case ROS_TYPE_UINT64:
+    case ROS_TYPE_INT64:
+      return 8u;
+    default:
+      return 0u;
+  }
+}
+
+const MessageMembers &
+nested_members(const MessageMember & member)
+{
+  return *static_cast<const MessageMembers *>(member.members_->data);
+}
+
+bool
+is_fixed_size_array(const MessageMember & member)
+{
+  return member.is_array_ && member.array_size_ > 0u && !member.is_upper_bound_;
+}
+
+/// Throw if a member can't be skipped, or read if requested, by the CDR reader.
+void
+check_member(const MessageMember & member, bool read)
+{
+  using namespace rosidl_typesupport_introspection_cpp;  // NOLINT
+  switch (member.type_id_) {
+    case ROS_TYPE_LONG_DOUBLE:
+    case ROS_TYPE_WCHAR:
+    case ROS_TYPE_WSTRING:
+      throw std::invalid_argument(
+              "field '" + std::string(member.name_) +
+              "' has a type which can't be partially deserialized");
+    case ROS_TYPE_BOOLEAN:
+      if (read && member.is_array_ && member.is_upper_bound_) {
+        throw std::invalid_argument(
+                "bounded boolean sequence '" + std::string(member.name_) +
+                "' can't be partially deserialized");
+      }
+      break;
+    case ROS_TYPE_MESSAGE:
+      {
+        const MessageMembers & members = nested_members(member);
+        for (uint32_t i = 0u; i < members.member_count_; ++i) {
+          check_member(members.members_[i], read);
+        }
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+/// Reader of the CDR encoding used by rmw_fastrtps_cpp and rmw_cyclonedds_cpp.
+class CdrReader
+{
+public:
+  explicit CdrReader(const rcl_serialized_message_t & serialized_message)
+  {
+    // The encapsulation header: 0x00 0x00 is big endian CDR, 0x00 0x01 little endian.
+    if (nullptr == serialized_message.buffer || serialized_message.buffer_length < 4u) {
+      throw std::runtime_error("serialized message is too short to be CDR encoded");
+    }
+    const uint8_t * buffer = serialized_message.buffer;
+    if (buffer[0] != 0u || buffer[1] > 1u) {
+      throw std::runtime_error("serialized message isn't plain CDR encoded");
+    }
+    const uint16_t one = 1u;
+    uint8_t host_little_endian = 0u;
+    std::memcpy(&host_little_endian, &one, 1u);
+    swap_ = buffer[1] != host_little_endian;
+    // Alignment is relative to the end of the encapsulation header.
+    data_ = buffer + 4u;
+    size_ = serialized_message.buffer_length - 4u;
+  }
+
+  /// Throw if count elements of the given size can't fit in the rest of the message.
+  void
+  check_count(size_t count, size_t element_size) const
+  {
+    if (count > (size_ - std::min(position_, size_)) / element_size) {
+      throw std::runtime_error("serialized message is truncated");
+    }
+  }
+
+  uint32_t
+  read_uint32()
+  {
+    uint32_t value;
+    read_primitives(&value, sizeof(value), 1u);
+    return value;
+  }
+
+  void
+  read_primitives(void * destination, size_t element_size, size_t count)
+  {
+    if (0u == count) {
+      return;
+    }
+    check_count(count, element_size);
+    const uint8_t * source = take(element_size, count * element_size);
+    auto bytes = static_cast<uint8_t *>(destination);
+    std::memcpy(bytes, source, count * element_size);
+    if (swap_ && element_size > 1u) {
+      for (size_t i = 0u; i < count; ++i) {
+        std::reverse(bytes + i * element_size, bytes + (i + 1u) * element_size);
+      }
+    }
+  }
+
+  void
+  read_booleans(bool * destination, size_t count)
+  {
+    check_count(count, 1u);
+    const uint8_t * source = take(1u, count);
+    for (size_t i = 0u; i < count; ++i) {
+      destination[i] = source[i] != 0u;
+    }
+  }
+
+  void
+  skip_primitives(size_t element_size, size_t count)
+  {
+    if (0u == count) {
+      return;
+    }
+    check_count(count, element_size);
+    take(element_size, count * element_size);
+  }
+
+  void
+  read_string(std::string & destination)
+  {
+    // The length includes the terminating null character.
+    const uint32_t length = read_uint32();
+    const auto * characters = reinterpret_cast<const char *>(take(1u, length));
+    destination.assign(characters, length > 0u ? length - 1u : 0u);
+  }
+
+  void
+  skip_string()
+  {
+    take(1u, read_uint32());
+  }
+
+  /// Align to the given size and consume the given number of bytes.
+  const uint8_t *
+  take(size_t alignment, size_t size)
+  {
+    const size_t start = (position_ + alignment - 1u) & ~(alignment - 1u);
+    if (start > size_ || size > size_ - start) {
+      throw std::runtime_error("serialized message is truncated");
+    }
+    position_ = start + size;
+    return data_ + start;
+  }
+
+private:
+  const uint8_t * data_ = nullptr;
+  size_t size_ = 0u;
+  size_t position_ = 0u;
+  bool swap_ = false;
+};
+
+void read_member(const MessageMember & member, CdrReader & reader, uint8_t * field);
+void skip_member(const MessageMember & member, CdrReader & reader);
+
+void
+read_message(const MessageMembers & members, CdrReader & reader, uint8_t * ros_message)
+{
+  for (uint32_t i = 0u; i < members.member_count_; ++i) {
+    const MessageMember & member = members.members_[i];
+    read_member(member, reader, ros_message + member.offset_);
+  }
+}
+
+void
+skip_message(const MessageMembers & members, CdrReader & reader)
+{
+  for (uint32_t i = 0u; i < members.member_count_; ++i) {
+    skip_member(members.members_[i], reader);
+  }
+}
+
+/// Read a single value, or an element of an array.
+void
+read_value(const MessageMember & member, CdrReader & reader, uint8_t * value)
+{
+  using namespace rosidl_typesupport_introspection_cpp;  // NOLINT
+  if (ROS_TYPE_BOOLEAN == member.type_id_) {
+    reader.read_booleans(reinterpret_cast<bool *>(value), 1u);
+  } else if (ROS_TYPE_STRING == member.type_id_) {
+    reader.read_string(*reinterpret_cast<std::string *>(value));
+  } else if (ROS_TYPE_MESSAGE == member.type_id_) {
+    read_message(nested_members(member), reader, value);
+  } else {
+    reader.read_primitives(value, cdr_primitive_size(member.type_id_), 1u);
+  }
+}
+
+void
+read_member(const MessageMember & member, CdrReader & reader, uint8_t * field)
+{
+  using namespace rosidl_typesupport_introspection_cpp;  // NOLINT
+  if (!member.is_array_) {
+    read_value(member, reader, field);
+    return;
+  }
+
+  const bool fixed_size = is_fixed_size_array(member);
+  const size_t count = fixed_size ? member.array_size_ : reader.read_uint32();
+  const size_t primitive_size = cdr_primitive_size(member.type_id_);
+  if (!fixed_size) {
+    // Don't allocate for a count a truncated or corrupted message can't hold.
+    reader.check_count(count, std::max<size_t>(primitive_size, 1u));
+  }
+
+  if (ROS_TYPE_BOOLEAN == member.type_id_ && !fixed_size) {
+    // std::vector<bool> doesn't store the values contiguously.
+    auto & values = *reinterpret_cast<std::vector<bool> *>(field);
+    values.resize(count);
+    for (size_t i = 0u; i < count; ++i) {
+      bool value;
+      reader.read_booleans(&value, 1u);
+      values[i] = value;
+    }
+    return;
+  }
+
+  if (!fixed_size) {
+    member.resize_function(field, count);
+  }
+  if (0u == count) {
+    return;
+  }
+  if (ROS_TYPE_BOOLEAN == member.type_id_) {
+    reader.read_booleans(reinterpret_cast<bool *>(field), count);
+  } else if (primitive_size > 0u) {
+    // The elements of std::array, std::vector and BoundedVector are contiguous.
+    void * data = fixed_size ? field : member.get_function(field, 0u);
+    reader.read_primitives(data, primitive_size, count);
+  } else {
+    for (size_t i = 0u; i < count; ++i) {
+      read_value(member, reader, static_cast<uint8_t *>(member.get_function(field, i)));
+    }
+  }
+}
+
+void
+skip_member(const MessageMember & member, CdrReader & reader)
+{
+  using namespace rosidl_typesupport_introspection_cpp;  // NOLINT
+  const size_t count = !member.is_array_ ? 1u :
+    (is_fixed_size_array(member) ? member.array_size_ : reader.read_uint32());
+  const size_t primitive_size = cdr_primitive_size(member.type_id_);
+  if (primitive_size > 0u) {
+    reader.skip_primitives(primitive_size, count);
+  } else if (ROS_TYPE_STRING == member.type_id_) {
+    for (size_t i = 0u; i < count; ++i) {
+      reader.skip_string();
+    }
+  } else {
+    const MessageMembers & members = nested_members(member);
+    for (size_t i = 0u; i < count; ++i) {
+      skip_message(members, reader);
+    }
+  }
+}
+
+}  // namespace
+
+struct PartialDeserializationBase::Plan
+{
+  enum class Action
+  {
+    Skip,
+    Read,
+    Descend,
+  };
+
+  struct Step
+  {
+    const MessageMember * member;
+    Action action;
+    // The level of the nested message, for Descend.
+    size_t level;
+  };
+
+  /// The members of a message up to the last one which is needed.
+  using Level = std::vector<Step>;
+
+  std::vector<Level> levels;
+
+  /// Add the level reading the given fields, paths relative to the message.
+  size_t
+  add_level(
+    const MessageMembers & members,
+    const std::vector<std::vector<std::string>> & paths)
+  {
+    for (const auto & path : paths) {
+      bool found = false;
+      for (uint32_t i = 0u; i < members.member_count_ && !found; ++i) {
+        found = path.front() == members.members_[i].name_;
+      }
+      if (!found) {
+        throw std::invalid_argument("unknown field '" + path.front() + "'");
+      }
+    }
+
+    Level level;
+    size_t last_needed = 0u;
+    for (uint32_t i = 0u; i < members.member_count_; ++i) {
+      const MessageMember & member = members.members_[i];
+      bool read = false;
+      std::vector<std::vector<std::string>> nested_paths;
+      for (const auto & path : paths) {
+        if (path.front() != member.name_) {
+          continue;
+        }
+        if (path.size() == 1u) {
+          read = true;
+        } else {
+          nested_paths.emplace_back(path.begin() + 1, path.end());
+        }
+      }
+      Step step{&member, Action::Skip, 0u};
+      if (read) {
+        step.action = Action::Read;
+      } else if (!nested_paths.empty()) {
+        if (member.type_id_ != rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE ||
+          member.is_array_)
+        {
+          throw std::invalid_argument(
+                  "field '" + std::string(member.name_) + "' has no member to deserialize");
+        }
+        step.action = Action::Descend;
+        step.level = add_level(nested_members(member), nested_paths);
+      }
+      if (step.action != Action::Skip) {
+        last_needed = level.size() + 1u;
+      }
+      level.push_back(step);
+    }
+    level.resize(last_needed);
+
+    for (const auto & step : level) {
+      if (step.action != Action::Descend) {
+        check_member(*step.member, step.action == Action::Read);
+      }
+    }
+    levels.push_back(std::move(level));
+    return levels.size() - 1u;
+  }
+
+  void
+  run(size_t level, CdrReader & reader, uint8_t * ros_message) const
+  {
+    for (const auto & step : levels[level]) {
+      switch (step.action) {
+        case Action::Skip:
+          skip_member(*step.member, reader);
+          break;
+        case Action::Read:
+          read_member(*step.member, reader, ros_message + step.member->offset_);
+          break;
+        case Action::Descend:
+          run(step.level, reader, ros_message + step.member->offset_);
+          break;
+      }
+    }
+  }
+};
+
+PartialDeserializationBase::PartialDeserializationBase(
+  const rosidl_message_type_support_t * type_support,
+  const std::vector<std::string> & fields)
+{
+  rcpputils::check_true(nullptr != type_support, "Typesupport is nullpointer.");
+  rcpputils::check_true(!fields.empty(), "No field to deserialize.");
+  const rosidl_message_type_support_t * introspection_type_support =
+    get_message_typesupport_handle(
+    type_support, rosidl_typesupport_introspection_cpp::typesupport_identifier);
+  if (nullptr == introspection_type_support) {
+    rcutils_reset_error();
+    throw std::invalid_argument(
+            "partial deserialization requires the rosidl_typesupport_introspection_cpp "
+            "type support");
+  }
+
+  std::vector<std::vector<std::string>> paths;
+  for (const auto & field : fields) {
+    std::vector<std::string> path;
+    size_t begin = 0u;
+    size_t end;
+    do {
+      end = field.find('.', begin);
+      path.push_back(field.substr(begin, end - begin));
+      begin = end + 1u;
+    } while (end != std::string::npos);
+    paths.push_back(std::move(path));
+  }
+
+  auto plan = std::make_shared<Plan>();
+  // The levels are added bottom up, so the top level message is the last one.
+  plan->add_level(
+    *static_cast<const MessageMembers *>(introspection_type_support->data), paths);
+  plan_ = std::move(plan);
+}
+
+PartialDeserializationBase::~PartialDeserializationBase()
+{}
+
+void PartialDeserializationBase::deserialize_message(
+  const SerializedMessage * serialized_message, void * ros_message) const
+{
+  rcpputils::check_true(nullptr != serialized_message, "Serialized message is nullpointer.");
+  deserialize_message_view(&serialized_message->get_rcl_serialized_message(), ros_message);
+}
+
+void PartialDeserializationBase::deserialize_message_view(
+  const rcl_serialized_message_t * serialized_message, void * ros_message) const
+{
+  rcpputils::check_true(nullptr != ros_message, "ROS message is nullpointer.");
+  rcpputils::check_true(nullptr != serialized_message, "Serialized message is nullpointer.");
+  CdrReader reader(*serialized_message);
+  plan_->run(plan_->levels.size() - 1u, reader, static_cast<uint8_t *>(ros_message));
+}
+
+}  // namespace rclcpp
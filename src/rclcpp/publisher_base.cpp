@@ -23,6 +23,7 @@
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "rcutils/logging_macros.h"
@@ -38,6 +39,7 @@
 #include "rclcpp/network_flow_endpoint.hpp"
 #include "rclcpp/node.hpp"
 #include "rclcpp/qos_event.hpp"
+#include "rclcpp/serialized_message.hpp"
 
 using rclcpp::PublisherBase;
 
@@ -272,6 +274,25 @@ PublisherBase::setup_intra_process(
   intra_process_is_enabled_ = true;
 }
 
+void
+PublisherBase::do_serialized_intra_process_publish(const rcl_serialized_message_t & serialized_msg)
+{
+  do_serialized_intra_process_publish(
+    std::make_shared<const rclcpp::SerializedMessage>(serialized_msg));
+}
+
+void
+PublisherBase::do_serialized_intra_process_publish(
+  std::shared_ptr<const rclcpp::SerializedMessage> serialized_msg)
+{
+  auto ipm = weak_ipm_.lock();
+  if (!ipm) {
+    throw std::runtime_error(
+            "intra process publish called after destruction of intra process manager");
+  }
+  ipm->do_serialized_intra_process_publish(intra_process_publisher_id_, std::move(serialized_msg));
+}
+
 void
 PublisherBase::default_incompatible_qos_callback(
   rclcpp::QOSOfferedIncompatibleQoSInfo & event) const
@@ -0,0 +1,169 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/publishing_thread_pool.hpp"
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include "rmw/impl/cpp/demangle.hpp"
+
+#include "rcutils/logging_macros.h"
+
+namespace rclcpp
+{
+
+PublishingThreadPool::PublishingThreadPool(size_t number_of_threads)
+{
+  if (0u == number_of_threads) {
+    throw std::invalid_argument("a publishing thread pool needs at least one thread");
+  }
+  workers_.reserve(number_of_threads);
+  for (size_t i = 0u; i < number_of_threads; ++i) {
+    workers_.emplace_back(std::make_unique<Worker>());
+  }
+  for (auto & worker : workers_) {
+    worker->thread = std::thread(&PublishingThreadPool::run, this, std::ref(*worker));
+  }
+}
+
+PublishingThreadPool::~PublishingThreadPool()
+{
+  shutdown();
+}
+
+void
+PublishingThreadPool::shutdown()
+{
+  std::lock_guard<std::mutex> shutdown_lock(shutdown_mutex_);
+  for (auto & worker : workers_) {
+    {
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      worker->stop = true;
+    }
+    worker->condition.notify_one();
+  }
+  for (auto & worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+}
+
+void
+PublishingThreadPool::enqueue(const void * key, std::function<void()> task)
+{
+  Worker & worker = *workers_[std::hash<const void *>{}(key) % workers_.size()];
+  {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.stop) {
+      return;
+    }
+    worker.tasks.emplace_back(std::move(task));
+  }
+  worker.condition.notify_one();
+}
+
+size_t
+PublishingThreadPool::get_number_of_threads() const
+{
+  return workers_.size();
+}
+
+size_t
+PublishingThreadPool::get_number_of_pending_tasks() const
+{
+  size_t pending_tasks = 0u;
+  for (const auto & worker : workers_) {
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    pending_tasks += worker->tasks.size();
+  }
+  return pending_tasks;
+}
+
+namespace
+{
+
+/// Sub context holding the default pool of a context, shut down before the context.
+struct DefaultPublishingThreadPool
+{
+  explicit DefaultPublishingThreadPool(rclcpp::Context & context)
+  {
+    // The context owns the sub context, so it is still alive when the callback is called.
+    context.add_pre_shutdown_callback(
+      [this]() {
+        PublishingThreadPool::SharedPtr default_pool;
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          default_pool = std::move(pool);
+        }
+        if (default_pool) {
+          default_pool->shutdown();
+        }
+      });
+  }
+
+  std::mutex mutex;
+  PublishingThreadPool::SharedPtr pool;
+};
+
+}  // namespace
+
+PublishingThreadPool::SharedPtr
+PublishingThreadPool::get_default_instance(const rclcpp::Context::SharedPtr & context)
+{
+  auto default_instance = context->get_sub_context<DefaultPublishingThreadPool>(*context);
+  std::lock_guard<std::mutex> lock(default_instance->mutex);
+  if (!default_instance->pool) {
+    default_instance->pool = std::make_shared<PublishingThreadPool>();
+  }
+  return default_instance->pool;
+}
+
+void
+PublishingThreadPool::run(Worker & worker)
+{
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(worker.mutex);
+      worker.condition.wait(lock, [&worker]() {return worker.stop || !worker.tasks.empty();});
+      if (worker.tasks.empty()) {
+        // Stopped, with every queued task run.
+        return;
+      }
+      task = std::move(worker.tasks.front());
+      worker.tasks.pop_front();
+    }
+    try {
+      task();
+    } catch (const std::exception & exc) {
+      RCUTILS_LOG_ERROR_NAMED(
+        "rclcpp",
+        "caught %s exception in publishing thread: %s",
+        rmw::impl::cpp::demangle(exc).c_str(),
+        exc.what());
+    } catch (...) {
+      RCUTILS_LOG_ERROR_NAMED(
+        "rclcpp",
+        "unknown error in publishing thread");
+    }
+  }
+}
+
+}  // namespace rclcpp
@@ -19,6 +19,7 @@
 
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/serialized_message.hpp"
+#include "rclcpp/serialized_message_batch.hpp"
 
 #include "rcpputils/asserts.hpp"
 
@@ -69,4 +70,30 @@ void SerializationBase::deserialize_message(
   }
 }
 
+void SerializationBase::serialize_message_to_batch(
+  const void * ros_message, SerializedMessageBatch * batch) const
+{
+  rcpputils::check_true(nullptr != batch, "Serialized message batch is nullpointer.");
+
+  auto & scratch = batch->get_scratch_message();
+  serialize_message(ros_message, &scratch);
+  batch->append(scratch);
+}
+
+void SerializationBase::deserialize_message_view(
+  const rcl_serialized_message_t * serialized_message, void * ros_message) const
+{
+  rcpputils::check_true(nullptr != type_support_, "Typesupport is nullpointer.");
+  rcpputils::check_true(nullptr != serialized_message, "Serialized message is nullpointer.");
+  rcpputils::check_true(
+    0u != serialized_message->buffer_length,
+    "Wrongly initialized. Serialized message has a size of zero.");
+  rcpputils::check_true(nullptr != ros_message, "ROS message is a nullpointer.");
+
+  const auto ret = rmw_deserialize(serialized_message, type_support_, ros_message);
+  if (ret != RMW_RET_OK) {
+    rclcpp::exceptions::throw_from_rcl_error(ret, "Failed to deserialize ROS message.");
+  }
+}
+
 }  // namespace rclcpp
@@ -15,6 +15,9 @@
 #include "rclcpp/serialized_message.hpp"
 
 #include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
 
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/logging.hpp"
@@ -55,9 +58,31 @@ SerializedMessage::SerializedMessage(
   }
 }
 
+SerializedMessage::SerializedMessage(
+  const void * data, size_t size, std::shared_ptr<const void> owner)
+: serialized_message_(rmw_get_zero_initialized_serialized_message()),
+  external_owner_(std::move(owner))
+{
+  if (nullptr == data || nullptr == external_owner_) {
+    throw std::invalid_argument("external serialized message data and owner must not be null");
+  }
+  // The buffer is only read while it is external, see detach_external_buffer().
+  serialized_message_.buffer = static_cast<uint8_t *>(const_cast<void *>(data));
+  serialized_message_.buffer_length = size;
+  serialized_message_.buffer_capacity = size;
+  serialized_message_.allocator = rcl_get_default_allocator();
+}
+
 SerializedMessage::SerializedMessage(const SerializedMessage & other)
-: SerializedMessage(other.serialized_message_)
-{}
+: serialized_message_(rmw_get_zero_initialized_serialized_message())
+{
+  if (other.external_owner_) {
+    serialized_message_ = other.serialized_message_;
+    external_owner_ = other.external_owner_;
+  } else {
+    copy_rcl_message(other.serialized_message_, serialized_message_);
+  }
+}
 
 SerializedMessage::SerializedMessage(const rcl_serialized_message_t & other)
 : serialized_message_(rmw_get_zero_initialized_serialized_message())
@@ -67,7 +92,8 @@ SerializedMessage::SerializedMessage(const rcl_serialized_message_t & other)
 
 SerializedMessage::SerializedMessage(SerializedMessage && other)
 : serialized_message_(
-    std::exchange(other.serialized_message_, rmw_get_zero_initialized_serialized_message()))
+    std::exchange(other.serialized_message_, rmw_get_zero_initialized_serialized_message())),
+  external_owner_(std::move(other.external_owner_))
 {}
 
 SerializedMessage::SerializedMessage(rcl_serialized_message_t && other)
@@ -79,7 +105,13 @@ SerializedMessage & SerializedMessage::operator=(const SerializedMessage & other
 {
   if (this != &other) {
     serialized_message_ = rmw_get_zero_initialized_serialized_message();
-    copy_rcl_message(other.serialized_message_, serialized_message_);
+    if (other.external_owner_) {
+      serialized_message_ = other.serialized_message_;
+      external_owner_ = other.external_owner_;
+    } else {
+      external_owner_.reset();
+      copy_rcl_message(other.serialized_message_, serialized_message_);
+    }
   }
 
   return *this;
@@ -89,6 +121,7 @@ SerializedMessage & SerializedMessage::operator=(const rcl_serialized_message_t
 {
   if (&serialized_message_ != &other) {
     serialized_message_ = rmw_get_zero_initialized_serialized_message();
+    external_owner_.reset();
     copy_rcl_message(other, serialized_message_);
   }
 
@@ -100,6 +133,7 @@ SerializedMessage & SerializedMessage::operator=(SerializedMessage && other)
   if (this != &other) {
     serialized_message_ =
       std::exchange(other.serialized_message_, rmw_get_zero_initialized_serialized_message());
+    external_owner_ = std::move(other.external_owner_);
   }
 
   return *this;
@@ -110,13 +144,15 @@ SerializedMessage & SerializedMessage::operator=(rcl_serialized_message_t && oth
   if (&serialized_message_ != &other) {
     serialized_message_ =
       std::exchange(other, rmw_get_zero_initialized_serialized_message());
+    external_owner_.reset();
   }
   return *this;
 }
 
 SerializedMessage::~SerializedMessage()
 {
-  if (nullptr != serialized_message_.buffer) {
+  // External memory is released with the last reference to its owner.
+  if (nullptr != serialized_message_.buffer && !external_owner_) {
     const auto fini_ret = rmw_serialized_message_fini(&serialized_message_);
     if (RCL_RET_OK != fini_ret) {
       RCLCPP_ERROR(
@@ -128,6 +164,7 @@ SerializedMessage::~SerializedMessage()
 
 rcl_serialized_message_t & SerializedMessage::get_rcl_serialized_message()
 {
+  detach_external_buffer();
   return serialized_message_;
 }
 
@@ -148,6 +185,7 @@ size_t SerializedMessage::capacity() const
 
 void SerializedMessage::reserve(size_t capacity)
 {
+  detach_external_buffer();
   auto ret = rmw_serialized_message_resize(&serialized_message_, capacity);
   if (RCL_RET_OK != ret) {
     rclcpp::exceptions::throw_from_rcl_error(ret);
@@ -156,9 +194,26 @@ void SerializedMessage::reserve(size_t capacity)
 
 rcl_serialized_message_t SerializedMessage::release_rcl_serialized_message()
 {
+  detach_external_buffer();
   auto ret = serialized_message_;
   serialized_message_ = rmw_get_zero_initialized_serialized_message();
 
   return ret;
 }
+
+bool SerializedMessage::is_external() const
+{
+  return nullptr != external_owner_;
+}
+
+void SerializedMessage::detach_external_buffer()
+{
+  if (!external_owner_) {
+    return;
+  }
+  auto owned = rmw_get_zero_initialized_serialized_message();
+  copy_rcl_message(serialized_message_, owned);
+  serialized_message_ = owned;
+  external_owner_.reset();
+}
 }  // namespace rclcpp
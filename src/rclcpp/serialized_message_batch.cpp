@@ -0,0 +1,130 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/serialized_message_batch.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "rmw/serialized_message.h"
+
+namespace rclcpp
+{
+
+constexpr size_t SerializedMessageBatch::alignment;
+
+SerializedMessageBatch::SerializedMessageBatch(
+  size_t initial_capacity, const rcl_allocator_t & allocator)
+: buffer_(initial_capacity, allocator),
+  scratch_(allocator)
+{}
+
+void SerializedMessageBatch::append(const rcl_serialized_message_t & serialized_message)
+{
+  auto & buffer = buffer_.get_rcl_serialized_message();
+  const size_t offset = (buffer.buffer_length + alignment - 1) & ~(alignment - 1);
+  const size_t end = offset + serialized_message.buffer_length;
+  if (end > buffer.buffer_capacity) {
+    // Grow geometrically, so that appending many messages stays linear.
+    reserve(std::max(end, 2 * buffer.buffer_capacity));
+  }
+  if (offset > buffer.buffer_length) {
+    // Zero the padding, so that the buffer content only depends on the messages.
+    std::memset(buffer.buffer + buffer.buffer_length, 0, offset - buffer.buffer_length);
+  }
+  if (serialized_message.buffer_length > 0u) {
+    std::memcpy(
+      buffer.buffer + offset, serialized_message.buffer, serialized_message.buffer_length);
+  }
+  buffer.buffer_length = end;
+  entries_.push_back({offset, serialized_message.buffer_length});
+}
+
+void SerializedMessageBatch::append(const SerializedMessage & serialized_message)
+{
+  append(serialized_message.get_rcl_serialized_message());
+}
+
+void SerializedMessageBatch::clear()
+{
+  buffer_.get_rcl_serialized_message().buffer_length = 0u;
+  entries_.clear();
+}
+
+void SerializedMessageBatch::reserve(size_t capacity)
+{
+  if (capacity > buffer_.capacity()) {
+    buffer_.reserve(capacity);
+  }
+}
+
+size_t SerializedMessageBatch::size() const
+{
+  return entries_.size();
+}
+
+bool SerializedMessageBatch::empty() const
+{
+  return entries_.empty();
+}
+
+size_t SerializedMessageBatch::bytes() const
+{
+  return buffer_.size();
+}
+
+size_t SerializedMessageBatch::capacity() const
+{
+  return buffer_.capacity();
+}
+
+const uint8_t * SerializedMessageBatch::data() const
+{
+  return buffer_.get_rcl_serialized_message().buffer;
+}
+
+const std::vector<SerializedMessageBatch::Entry> & SerializedMessageBatch::entries() const
+{
+  return entries_;
+}
+
+rcl_serialized_message_t SerializedMessageBatch::view(size_t index) const
+{
+  if (index >= entries_.size()) {
+    throw std::out_of_range("serialized message batch index out of range");
+  }
+  const auto & entry = entries_[index];
+  return make_serialized_message_view(data() + entry.offset, entry.size);
+}
+
+SerializedMessage & SerializedMessageBatch::get_scratch_message()
+{
+  return scratch_;
+}
+
+rcl_serialized_message_t
+make_serialized_message_view(const void * data, size_t size)
+{
+  auto view = rmw_get_zero_initialized_serialized_message();
+  // The data is never written through the view, it is only handed to rmw_deserialize().
+  view.buffer = static_cast<uint8_t *>(const_cast<void *>(data));
+  view.buffer_length = size;
+  view.buffer_capacity = size;
+  view.allocator = rcl_get_default_allocator();
+  return view;
+}
+
+}  // namespace rclcpp
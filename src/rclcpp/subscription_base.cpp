@@ -16,12 +16,15 @@
 
 #include <cstdio>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "rcpputils/scope_exit.hpp"
 
+#include "rclcpp/detail/content_filter.hpp"
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/expand_topic_or_service_name.hpp"
 #include "rclcpp/experimental/intra_process_manager.hpp"
@@ -186,9 +189,65 @@ SubscriptionBase::take_serialized(
   } else if (RCL_RET_OK != ret) {
     rclcpp::exceptions::throw_from_rcl_error(ret);
   }
+  if (
+    matches_any_intra_process_publishers(&message_info_out.get_rmw_message_info().publisher_gid))
+  {
+    // In this case, the message will be delivered via intra-process and
+    // we should ignore this copy of the message.
+    return false;
+  }
   return true;
 }
 
+std::shared_ptr<void>
+SubscriptionBase::borrow_receive_message()
+{
+  if (receive_message_borrowed_.exchange(true)) {
+    return nullptr;
+  }
+  if (!receive_message_) {
+    receive_message_ = create_message();
+  }
+  return receive_message_;
+}
+
+void
+SubscriptionBase::return_receive_message(std::shared_ptr<void> & message)
+{
+  message.reset();
+  if (receive_message_.use_count() > 1) {
+    // The callback kept a reference, give the message back and don't overwrite it.
+    return_message(receive_message_);
+    receive_message_.reset();
+  }
+  receive_message_borrowed_.store(false);
+}
+
+std::shared_ptr<rclcpp::SerializedMessage>
+SubscriptionBase::borrow_receive_serialized_message()
+{
+  if (receive_serialized_message_borrowed_.exchange(true)) {
+    return nullptr;
+  }
+  if (!receive_serialized_message_) {
+    receive_serialized_message_ = create_serialized_message();
+  }
+  return receive_serialized_message_;
+}
+
+void
+SubscriptionBase::return_receive_serialized_message(
+  std::shared_ptr<rclcpp::SerializedMessage> & message)
+{
+  message.reset();
+  if (receive_serialized_message_.use_count() > 1) {
+    // The callback kept a reference, give the message back and don't overwrite it.
+    return_serialized_message(receive_serialized_message_);
+    receive_serialized_message_.reset();
+  }
+  receive_serialized_message_borrowed_.store(false);
+}
+
 const rosidl_message_type_support_t &
 SubscriptionBase::get_message_type_support_handle() const
 {
@@ -400,9 +459,38 @@ SubscriptionBase::set_content_filter(
     subscription_handle_.get(),
     &options);
 
-  if (RCL_RET_OK != ret) {
+  if (RCL_RET_UNSUPPORTED == ret) {
+    // The middleware doesn't filter, only the intra-process messages are filtered.
+    rcl_reset_error();
+  } else if (RCL_RET_OK != ret) {
     rclcpp::exceptions::throw_from_rcl_error(ret, "failed to set cft expression parameters");
   }
+
+  set_intra_process_content_filter(filter_expression, expression_parameters);
+}
+
+void
+SubscriptionBase::set_intra_process_content_filter(
+  const std::string & filter_expression,
+  const std::vector<std::string> & expression_parameters)
+{
+  if (!subscription_intra_process_ || is_serialized_) {
+    return;
+  }
+  std::shared_ptr<const rclcpp::detail::ContentFilter> content_filter;
+  if (!filter_expression.empty()) {
+    try {
+      content_filter = std::make_shared<const rclcpp::detail::ContentFilter>(
+        type_support_, filter_expression, expression_parameters);
+    } catch (const std::invalid_argument & e) {
+      RCLCPP_WARN(
+        node_logger_,
+        "Content filter of subscription on topic '%s' can't be applied to intra-process "
+        "messages, all of them will be received: %s",
+        get_topic_name(), e.what());
+    }
+  }
+  subscription_intra_process_->set_content_filter(std::move(content_filter));
 }
 
 rclcpp::ContentFilterOptions
@@ -15,6 +15,10 @@
 #include "rclcpp/experimental/subscription_intra_process_base.hpp"
 #include "rclcpp/detail/add_guard_condition_to_rcl_wait_set.hpp"
 
+#include <memory>
+#include <mutex>
+#include <utility>
+
 using rclcpp::experimental::SubscriptionIntraProcessBase;
 
 SubscriptionIntraProcessBase::~SubscriptionIntraProcessBase()
@@ -39,3 +43,19 @@ SubscriptionIntraProcessBase::get_actual_qos() const
 {
   return qos_profile_;
 }
+
+void
+SubscriptionIntraProcessBase::set_content_filter(
+  std::shared_ptr<const rclcpp::detail::ContentFilter> content_filter)
+{
+  std::lock_guard<std::mutex> lock(content_filter_mutex_);
+  has_content_filter_.store(content_filter != nullptr, std::memory_order_release);
+  content_filter_ = std::move(content_filter);
+}
+
+std::shared_ptr<const rclcpp::detail::ContentFilter>
+SubscriptionIntraProcessBase::get_content_filter() const
+{
+  std::lock_guard<std::mutex> lock(content_filter_mutex_);
+  return content_filter_;
+}
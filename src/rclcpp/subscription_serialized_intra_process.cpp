@@ -0,0 +1,89 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/experimental/subscription_serialized_intra_process.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "rclcpp/experimental/create_intra_process_buffer.hpp"
+
+using rclcpp::experimental::SubscriptionSerializedIntraProcess;
+
+SubscriptionSerializedIntraProcess::SubscriptionSerializedIntraProcess(
+  CallbackT callback,
+  rclcpp::Context::SharedPtr context,
+  const std::string & topic_name,
+  const rclcpp::QoS & qos_profile)
+: SubscriptionIntraProcessBase(context, topic_name, qos_profile),
+  callback_(std::move(callback))
+{
+  // Serialized messages are always shared between the subscriptions, the ring buffer
+  // keeps at most qos depth of them.
+  buffer_ = rclcpp::experimental::create_intra_process_buffer<rclcpp::SerializedMessage>(
+    rclcpp::IntraProcessBufferType::SharedPtr,
+    qos_profile,
+    std::make_shared<std::allocator<void>>());
+}
+
+SubscriptionSerializedIntraProcess::~SubscriptionSerializedIntraProcess()
+{}
+
+bool
+SubscriptionSerializedIntraProcess::is_ready(rcl_wait_set_t * wait_set)
+{
+  (void) wait_set;
+  return buffer_->has_data();
+}
+
+std::shared_ptr<void>
+SubscriptionSerializedIntraProcess::take_data()
+{
+  auto message = buffer_->consume_shared();
+  if (!message) {
+    return nullptr;
+  }
+  return std::const_pointer_cast<rclcpp::SerializedMessage>(std::move(message));
+}
+
+void
+SubscriptionSerializedIntraProcess::execute(std::shared_ptr<void> & data)
+{
+  if (!data) {
+    return;
+  }
+  auto message = std::static_pointer_cast<rclcpp::SerializedMessage>(std::move(data));
+  if (message.use_count() > 1) {
+    // Other subscriptions or the publisher still hold the message, don't let the
+    // callback modify it.
+    message = std::make_shared<rclcpp::SerializedMessage>(*message);
+  }
+  callback_(std::move(message));
+}
+
+void
+SubscriptionSerializedIntraProcess::provide_serialized_intra_process_message(
+  std::shared_ptr<const rclcpp::SerializedMessage> serialized_message)
+{
+  buffer_->add_shared(std::move(serialized_message));
+  trigger_guard_condition();
+  this->invoke_on_new_message();
+}
+
+void
+SubscriptionSerializedIntraProcess::trigger_guard_condition()
+{
+  this->gc_.trigger();
+}
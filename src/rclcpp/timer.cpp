@@ -17,6 +17,7 @@
 #include <chrono>
 #include <string>
 #include <memory>
+#include <stdexcept>
 #include <thread>
 
 #include "rclcpp/contexts/default_context.hpp"
@@ -138,3 +139,18 @@ TimerBase::exchange_in_use_by_wait_set_state(bool in_use_state)
 {
   return in_use_by_wait_set_.exchange(in_use_state);
 }
+
+void
+TimerBase::set_slack(std::chrono::nanoseconds slack)
+{
+  if (slack < std::chrono::nanoseconds::zero()) {
+    throw std::invalid_argument{"timer slack must not be negative"};
+  }
+  slack_ns_.store(slack.count(), std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds
+TimerBase::get_slack() const
+{
+  return std::chrono::nanoseconds(slack_ns_.load(std::memory_order_relaxed));
+}